@@ -15,36 +15,28 @@
 #include "sys_rawinput.h"
 //For OpenGL Commands 
 #include "sys_gl.h"
-//Our CPU Core
-#include "cpu_6502.h"
 //For logging
 #include "sys_log.h"
 //For simple OpenGL line drawing
 #include "emu_vector_draw.h"
 //For Performance profiling
 #include <chrono>
+#include "sys_perf.h"
+#include "sys_trace.h"
 using namespace std;
 using namespace chrono;
 //To remove annoying warning for fopen.
 #pragma warning(disable:4996 4102)
 
-//The Game Memory Image
-unsigned char* GI = nullptr;
-//CPU Class
-cpu_6502* CPU;
-//Vector Drawing Class
-EmuDraw2D* emuscreen;
+//The machine driven by asteroid_init/asteroid_run
+static std::unique_ptr<AsteroidsMachine> machine;
 
 //Configuration variables
 int closeit = 0;
-int testsw = 0;
+int trace_capture = 0; // 1 = write trace.json on exit, open it in ui.perfetto.dev
 
-unsigned char* vec_mem;
-
-UINT32 m6502NmiTicks = 0;
-UINT32 dwElapsedTicks = 0;
-
-int lastret = 0;
+//Frame phase id for the host side drawing, see sys_perf.h
+int ph_draw;
 
 
 
@@ -53,23 +45,21 @@ int lastret = 0;
 //DVG Code Below
 #define MAKE_RGB(r,g,b) ((((r) & 0xff) << 16) | (((g) & 0xff) << 8) | ((b) & 0xff))
 #define vector_word(address) ((GI[pc]) | (GI[pc+1]<<8))
-int twos_comp_val(int num, int bits) { return (num << (32 - bits)) >> (32 - bits); }
+static int twos_comp_val(int num, int bits) { return (num << (32 - bits)) >> (32 - bits); }
 
-void LoadRom(const char* Filename, int Offset, int Size)
+static bool LoadRom(unsigned char* mem, const char* dir, const char* Filename, int Offset, int Size)
 {
+	char path[MAX_PATH];
 	FILE* fp = NULL;
 
-	fp = fopen(Filename, "rb");
-	if (fp)
-	{
-		fread(GI + Offset, Size, 1, fp);
-		fclose(fp);
-	}
-	else
-	{
-		allegro_message("ROM MISSING","Please make sure the current M.A.M.E (TM) roms for \"asteroid\" are \rextracted to the roms\\asteroid folder!\r035127-02.np3\r035145-04e.ef2\r035144-04e.h2\r035143-02.j2\r034602-01.c8");
-		exit(1);
-	}
+	sprintf_s(path, sizeof(path), "%s\\%s", dir, Filename);
+	fp = fopen(path, "rb");
+	if (!fp)
+		return false;
+
+	fread(mem + Offset, Size, 1, fp);
+	fclose(fp);
+	return true;
 }
 
 void CloseProgram(void)
@@ -78,31 +68,22 @@ void CloseProgram(void)
 }
 
 ////////////  CALL ASTEROIDS SWAPRAM  ////////////////////////////////////////////
-void SwapRam(UINT32 address, UINT8 data, struct MemoryWriteByte* psMemWrite)
+void AsteroidsMachine::swap_ram(UINT8 data)
 {
-	static int asteroid_bank = 0;
 	int asteroid_newbank;
-	UINT8 buffer[0x100];
 
 	asteroid_newbank = (data >> 2) & 1;
-	if (asteroid_bank != asteroid_newbank)
+	if (bank != asteroid_newbank)
 	{
-		// Perform bankswitching on page 2 and page 3
-		asteroid_bank = asteroid_newbank;
-		memcpy(buffer, GI + 0x200, 0x100);
-		memcpy(GI + 0x200, GI + 0x300, 0x100);
-		memcpy(GI + 0x300, buffer, 0x100);
+		// Perform bankswitching on page 2 and page 3. The two pages of RAM stay
+		// where they are in GI, the CPU's page map just points each at the other.
+		bank = asteroid_newbank;
+		CPU->map_memory(0x200, 0x100, GI.get() + (bank ? 0x300 : 0x200));
+		CPU->map_memory(0x300, 0x100, GI.get() + (bank ? 0x200 : 0x300));
 	}
 }
 
-void NoWrite(UINT32 address, UINT8 data, struct MemoryWriteByte* psMemWrite)
-{}
-
-void AudioOut(UINT32 address, UINT8 data, struct MemoryWriteByte* psMemWrite)
-{
-}
-
-void dvg_generate_vector_list()
+void AsteroidsMachine::dvg_generate_vector_list()
 {
 	int pc = 0x4000;
 	int sp = 0;
@@ -202,7 +183,7 @@ void dvg_generate_vector_list()
 			if (z)
 			{
 				z = (z << 4) + 15;
-				emuscreen->add_line((float) currentx, (float) currenty,(float) (currentx + deltax), (float) (currenty - deltay), MAKE_RGBA(z, z, z, 0xff));
+				screen.add_line((float) currentx, (float) currenty,(float) (currentx + deltax), (float) (currenty - deltay), MAKE_RGBA(z, z, z, 0xff));
 			}
 
 			currentx += deltax;
@@ -259,13 +240,17 @@ void dvg_generate_vector_list()
 	}
 }
 
-void BWVectorGeneratorInternal(UINT32 address, UINT8 data, struct MemoryWriteByte* psMemWrite)
+void AsteroidsMachine::vector_generator()
 {
+	if (timing)
+		Perf::begin(ph_dvg);
 	dvg_generate_vector_list();
+	if (timing)
+		Perf::end();
 }
 
 /////////////////////READ KEYS FROM PIA 1 //////////////////////////////////////
-UINT8 AstPIA1Read(UINT32 address, struct MemoryReadByte* psMemRead)
+UINT8 AsteroidsMachine::pia1_read(UINT32 address)
 {
 	switch (address)
 	{
@@ -285,7 +270,16 @@ UINT8 AstPIA1Read(UINT32 address, struct MemoryReadByte* psMemRead)
 	return 0x7f;
 }
 
-UINT8 AstPIA2Read(UINT32 address, struct MemoryReadByte* psMemRead)
+// Debugger view of PIA 1, reports the 3K clock without toggling it.
+UINT8 AsteroidsMachine::pia1_peek(UINT32 address)
+{
+	if (address == 0x01)
+		return lastret ? 0x7f : 0x80;
+
+	return pia1_read(address);
+}
+
+UINT8 AsteroidsMachine::pia2_read(UINT32 address) const
 {
 	switch (address)
 	{
@@ -317,61 +311,125 @@ UINT8 AstPIA2Read(UINT32 address, struct MemoryReadByte* psMemRead)
 	return 0x7f;
 }
 
-///////////////////////  MAIN LOOP /////////////////////////////////////
-void asteroid_run()
+///////////////////////  BUS  /////////////////////////////////////
+inline uint8_t AsteroidsBus::io_read(int device, uint16_t offset)
+{
+	if (device == PIA1)
+		return machine->pia1_read(offset);
+	return machine->pia2_read(offset);
+}
+
+inline void AsteroidsBus::io_write(int device, uint16_t offset, uint8_t data)
+{
+	switch (device)
+	{
+	case DVG:  machine->vector_generator(); break;
+	case BANK: machine->swap_ram(data); break;
+	case SOUND: break;
+	}
+}
+
+// PIA 2 has no side effects, it is its own debug read.
+int AsteroidsBus::io_peek(int device, uint16_t offset) const
+{
+	if (device == PIA1)
+		return machine->pia1_peek(offset);
+	return machine->pia2_read(offset);
+}
+
+///////////////////////  MACHINE  /////////////////////////////////////
+AsteroidsMachine::AsteroidsMachine()
+	: GI(new unsigned char[0x10000]())
+{
+	/* Set the context in the 6502 emulator core */
+	CPU.reset(new AsteroidCpu(GI.get(), nullptr, nullptr, 0x7fff, 1));
+	CPU->bus.machine = this;
+	CPU->log_unhandled_rw(0);
+	CPU->mame_memory_handling(0);
+
+	/* Set up some defaults so that the Asteroids code actually runs the game
+	* and not just diag mode.
+	*/
+	GI[0x2800] = 0x02; //ff 2 coins 1 play 00 free play /02 1 coin 1 play
+	GI[0x2801] = 0xff; // Just to clear random values
+	GI[0x2802] = 0x0f; // number of ships
+	GI[0x2803] = 0x00; //01 german /04 spanish /00 english 03 french
+}
+
+bool AsteroidsMachine::load_roms(const char* dir)
+{
+	bool ok = LoadRom(GI.get(), dir, "035127-02.np3", 0x5000, 0x800)
+		&& LoadRom(GI.get(), dir, "035145-04e.ef2", 0x6800, 0x800)
+		&& LoadRom(GI.get(), dir, "035144-04e.h2", 0x7000, 0x800)
+		&& LoadRom(GI.get(), dir, "035143-02.j2", 0x7800, 0x800);
+
+	/* Now reset the processor to fetch the start vector */
+	if (ok)
+		reset();
+	return ok;
+}
+
+void AsteroidsMachine::reset()
+{
+	CPU->reset6502();
+}
+
+void AsteroidsMachine::enable_timing(bool on)
+{
+	//Frame timing phases. DVG decode runs inside a CPU write, it is timed separately.
+	//Looked up here so a machine that is never timed never touches Perf.
+	if (on)
+	{
+		ph_cpu = Perf::phase("cpu");
+		ph_dvg = Perf::phase("dvg");
+	}
+	timing = on;
+}
+
+void AsteroidsMachine::toggle_test_switch()
+{
+	testsw ^= 1;
+	reset();
+}
+
+void AsteroidsMachine::run_frame()
 {
 	//Speed 1512000/60/4ish interrupts per frame/ 4.1 is accurate, but Asteroids is very forgiving and it doesn't
 	//really matter or affect the emulation speed.
 
+	if (timing)
+		Perf::begin(ph_cpu);
+	for (int slice = 0; slice < 4; slice++)
+	{
+		CPU->exec6502(6150);
+		CPU->nmi6502();
+	}
+	if (timing)
+		Perf::end();
+}
+
+///////////////////////  MAIN LOOP /////////////////////////////////////
+void asteroid_run()
+{
 	if (key[KEY_ESC]) { closeit = 1; }
 	if (key[KEY_F2]) {
-		Sleep(300); testsw ^= 1;
-		CPU->reset6502();
+		Sleep(300);
+		machine->toggle_test_switch();
 	}
 
-	auto start = chrono::steady_clock::now();
-
-	CPU->exec6502(6150);
-	CPU->nmi6502();
-	CPU->exec6502(6150);
-	CPU->nmi6502();
-	CPU->exec6502(6150);
-	CPU->nmi6502();
-	CPU->exec6502(6150);
-	CPU->nmi6502();
-	auto end = chrono::steady_clock::now();
-	auto diff = end - start;
-	wrlog("CPU Time this frame is %f milliseconds.", chrono::duration <double, milli>(diff).count());
-	emuscreen->draw_all();
+	machine->run_frame();
+
+	Perf::begin(ph_draw);
+	machine->draw();
+	Perf::end();
 }
 
 void asteroid_end()
 {
-	free(CPU);
-	free(GI);
-	free(emuscreen);
+	machine.reset();
 	wrlog("asteroids shutting down");
 }
 
-struct MemoryWriteByte AsteroidWrite[] =
-{
-	{ 0x3000, 0x3000, BWVectorGeneratorInternal},
-	{ 0x3200, 0x3200, SwapRam},
-	{ 0x3600, 0x3600, AudioOut},
-	{ 0x3a00, 0x3a00, AudioOut},
-	{ 0x3c00, 0x3c05, AudioOut},
-	{ 0x6800, 0x7fff, NoWrite },
-	{ 0x5000, 0x57ff, NoWrite },
-	{(UINT32)-1,	(UINT32)-1,		NULL}
-};
-
-struct MemoryReadByte AsteroidRead[] =
-{
-	{ 0x2000, 0x2007, AstPIA1Read},
-	{ 0x2400, 0x2407, AstPIA2Read},
-	{(UINT32)-1,	(UINT32)-1,		NULL}
-};
-
 int asteroid_init()
 {
 	// SETUP OPENGL
@@ -389,54 +447,20 @@ int asteroid_init()
 	glLineWidth(2.0f);
 	glPointSize(1.8f);
 
-	//Initialize our super simple drawing class.
-	emuscreen = new EmuDraw2D();
+	ph_draw = Perf::phase("draw");
+
+	if (trace_capture)
+		Trace::enable(true);
+
+	machine.reset(new AsteroidsMachine());
+	machine->enable_timing(true);
 
-	//Inialize memory for the Game Image
-	GI = (unsigned char*)malloc(65536);
-	if (GI == NULL)
+	// load romsets:
+	if (!machine->load_roms("roms\\asteroid"))
 	{
-		wrlog("Error, Can't allocate system ram!");
+		allegro_message("ROM MISSING","Please make sure the current M.A.M.E (TM) roms for \"asteroid\" are \rextracted to the roms\\asteroid folder!\r035127-02.np3\r035145-04e.ef2\r035144-04e.h2\r035143-02.j2\r034602-01.c8");
 		exit(1);
 	}
-	// Clear Memory
-	for (int loop = 0; loop < 0x10000; loop++)
-		GI[loop] = (char)0x00;
-	// load romsets:
-
-	LoadRom("roms\\asteroid\\035127-02.np3", 0x5000, 0x800);
-	LoadRom("roms\\asteroid\\035145-04e.ef2", 0x6800, 0x800);
-	LoadRom("roms\\asteroid\\035144-04e.h2", 0x7000, 0x800);
-	LoadRom("roms\\asteroid\\035143-02.j2", 0x7800, 0x800);
-
-	/* Now that everything's ready to go, let's go ahead and fire up the
-	* CPU emulator
-	*/
-	/* First set the base address of the 64K image */
-	/* Now set up the read/write handlers for the emulation */
-	/* Set the context in the 6502 emulator core */
-	CPU = new cpu_6502(GI, AsteroidRead, AsteroidWrite, 0x7fff, 1);
-	/* Now reset the processor to fetch the start vector */
-	CPU->reset6502();
-	CPU->log_unhandled_rw(0);
-	CPU->mame_memory_handling(0);
-
-	/* Set up some defaults so that the Asteroids code actually runs the game
-	* and not just diag mode.
-	*/
-	GI[0x2000] = 0x7f;
-	GI[0x2001] = 0x7f;
-	GI[0x2002] = 0x7f;
-	GI[0x2003] = 0x7f;
-	GI[0x2004] = 0x7f;
-	GI[0x2005] = 0x7f;
-	GI[0x2006] = 0x7f;
-	GI[0x2007] = 0x7f;
-
-	GI[0x2800] = 0x02; //ff 2 coins 1 play 00 free play /02 1 coin 1 play
-	GI[0x2801] = 0xff; // Just to clear random values
-	GI[0x2802] = 0x0f; // number of ships
-	GI[0x2803] = 0x00; //01 german /04 spanish /00 english 03 french
 	///END!!!
 	return 0;
 }
@@ -32,6 +32,98 @@ For more information, please refer to <http://unlicense.org/>
 #ifndef ASTEROID_H
 #define ASTEROID_H
 
+#include <memory>
+#include "cpu_6502.h"
+#include "cpu_6502_chrome_trace.h"
+#include "emu_vector_draw.h"
+
+class AsteroidsMachine;
+
+// The Asteroids memory map never changes, so it is a fixed bus (cpu_6502_bus.h).
+// The CPU resolves it inline and calls io_read/io_write directly.
+struct AsteroidsBus : cpu6502_fixed_bus<AsteroidsBus>
+{
+	enum { PIA1, PIA2, DVG, BANK, SOUND };
+
+	// Same map as the old handler tables: anything not listed here is plain MEM.
+	static constexpr cpu6502_bus_range ranges[] = {
+		bus_io_read(0x2000, 0x2007, PIA1),
+		bus_io_read(0x2400, 0x2407, PIA2),
+		bus_io_write(0x3000, 0x3000, DVG),
+		bus_io_write(0x3200, 0x3200, BANK),
+		bus_io_write(0x3600, 0x3600, SOUND),
+		bus_io_write(0x3A00, 0x3A00, SOUND),
+		bus_io_write(0x3C00, 0x3C05, SOUND),
+		bus_rom(0x5000, 0x57FF),              // Vector ROM
+		bus_rom(0x6800, 0x7FFF),              // Program ROM
+		bus_ram(0x0000, 0xFFFF),              // RAM, DIP switches, watchdog, vector RAM
+	};
+
+	AsteroidsMachine* machine = nullptr;
+
+	uint8_t io_read(int device, uint16_t offset);
+	void io_write(int device, uint16_t offset, uint8_t data);
+	int io_peek(int device, uint16_t offset) const;
+};
+
+//CPU type, with exec slices and NMIs going to the trace when it is enabled
+typedef cpu_6502_core<cpu6502_chrome_trace_hooks, AsteroidsBus> AsteroidCpu;
+
+// One Asteroids board: memory image, CPU, vector list and device state.
+// Nothing is shared between instances, the bus finds its machine through
+// its own pointer, so several machines can run in one process or on separate
+// threads. Keyboard input (key[]) is read by every machine, and the Chrome
+// trace buffer takes their CPU events under a lock. Perf timing is off by
+// default and only enable_timing(true) touches Perf, since the Perf phases are
+// process wide and not thread safe: time one machine, on the main thread.
+class AsteroidsMachine
+{
+public:
+	AsteroidsMachine();
+	~AsteroidsMachine() = default;
+	AsteroidsMachine(const AsteroidsMachine&) = delete;
+	AsteroidsMachine& operator=(const AsteroidsMachine&) = delete;
+
+	// Loads the romset from dir and resets the CPU. Returns false if a rom is missing.
+	bool load_roms(const char* dir);
+
+	void reset();
+	// One 60Hz frame: four exec slices, each followed by an NMI.
+	void run_frame();
+	void draw() { screen.draw_all(); }
+
+	void toggle_test_switch();
+	void enable_timing(bool on);
+
+	AsteroidCpu& cpu() { return *CPU; }
+	unsigned char* memory() { return GI.get(); }
+
+private:
+	friend struct AsteroidsBus;
+
+	UINT8 pia1_read(UINT32 address);
+	UINT8 pia1_peek(UINT32 address);
+	UINT8 pia2_read(UINT32 address) const;
+	void swap_ram(UINT8 data);
+	void vector_generator();
+
+	void dvg_generate_vector_list();
+
+	//The Game Memory Image
+	std::unique_ptr<unsigned char[]> GI;
+	std::unique_ptr<AsteroidCpu> CPU;
+	//Vector Drawing Class
+	EmuDraw2D screen;
+
+	int testsw = 0;
+	int lastret = 0;
+	int bank = 0;
+	bool timing = false;
+	//Frame phase ids, see sys_perf.h
+	int ph_cpu = 0, ph_dvg = 0;
+};
+
+// Single machine driven by the main window.
 int asteroid_init();
 void asteroid_run();
 void asteroid_end();
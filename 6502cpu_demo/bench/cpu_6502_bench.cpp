@@ -0,0 +1,104 @@
+// -----------------------------------------------------------------------------
+// AAE (Another Arcade Emulator) - 6502 Core Benchmark
+//
+// This file is part of the AAE project and is released under The Unlicense.
+// You are free to use, modify, and distribute this software without restriction.
+// See <http://unlicense.org/> for details.
+//
+// Runs N cores round robin, a short slice of cycles each, the way a multi-CPU
+// driver interleaves them. All of them run the same loop on one shared memory
+// image, so the only thing that grows with N is the set of core objects. Once
+// they no longer fit in L1 and then L2, the time per emulated cycle shows how
+// many cache lines a core drags in each time it is switched to. The fused
+// column is the same run with enable_superinstructions(true).
+//
+// Standalone, not part of the demo project. From this directory:
+//   cl /O2 /EHsc /std:c++17 /I.. cpu_6502_bench.cpp ..\cpu_6502.cpp ..\sys_log.cpp
+//   cpu_6502_bench [slice_cycles] [total_mcycles]
+// -----------------------------------------------------------------------------
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <vector>
+#include "cpu_6502.h"
+
+static uint8_t mem[0x10000];
+
+static MemoryReadByte no_reads[] = { { (unsigned)-1, (unsigned)-1, nullptr } };
+static MemoryWriteByte no_writes[] = { { (unsigned)-1, (unsigned)-1, nullptr } };
+
+// Indexed load, add, indexed store, a subroutine call and a counted loop.
+static void load_program()
+{
+	static const uint8_t main_loop[] = {
+		0xA2, 0x10,       // $0200 LDX #$10
+		0xB5, 0x10,       // $0202 LDA $10,X
+		0x18,             //       CLC
+		0x69, 0x03,       //       ADC #$03
+		0x9D, 0x00, 0x03, //       STA $0300,X
+		0x20, 0x00, 0x04, //       JSR $0400
+		0xCA,             //       DEX
+		0xD0, 0xF2,       //       BNE $0202
+		0xE6, 0x20,       //       INC $20
+		0x4C, 0x00, 0x02  //       JMP $0200
+	};
+	static const uint8_t sub[] = {
+		0xA4, 0x21,       // $0400 LDY $21
+		0xC8,             //       INY
+		0x84, 0x21,       //       STY $21
+		0x60              //       RTS
+	};
+
+	memcpy(mem + 0x0200, main_loop, sizeof(main_loop));
+	memcpy(mem + 0x0400, sub, sizeof(sub));
+	mem[0xFFFC] = 0x00;
+	mem[0xFFFD] = 0x02;
+}
+
+static double run(int instances, int slice, long long total_cycles, bool fused)
+{
+	std::vector<std::unique_ptr<cpu_6502>> cpus;
+	for (int i = 0; i < instances; i++)
+	{
+		cpus.push_back(std::make_unique<cpu_6502>(mem, no_reads, no_writes, 0xFFFF, i));
+		cpus.back()->enable_superinstructions(fused);
+		cpus.back()->reset6502();
+	}
+
+	const long long rounds = total_cycles / ((long long)instances * slice) + 1;
+	long long cycles = 0;
+
+	const auto start = std::chrono::steady_clock::now();
+	for (long long r = 0; r < rounds; r++)
+	{
+		for (auto& cpu : cpus)
+			cycles += cpu->exec6502(slice);
+	}
+	const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	return seconds * 1.0e9 / (double)cycles;
+}
+
+int main(int argc, char** argv)
+{
+	const int slice = argc > 1 ? atoi(argv[1]) : 100;
+	const long long total = (argc > 2 ? atoll(argv[2]) : 200) * 1000000LL;
+
+	load_program();
+
+	printf("sizeof(cpu_6502) %u, alignof %u, slice %d cycles\n",
+		(unsigned)sizeof(cpu_6502), (unsigned)alignof(cpu_6502), slice);
+	printf("instances  ns/cycle  fused ns/cycle  emulated MHz\n");
+
+	static const int counts[] = { 1, 4, 16, 64, 256, 1024, 4096 };
+	for (int n : counts)
+	{
+		const double ns = run(n, slice, total, false);
+		const double fused = run(n, slice, total, true);
+		printf("%9d  %8.3f  %14.3f  %12.1f\n", n, ns, fused, 1000.0 / ns);
+	}
+	return 0;
+}
@@ -23,6 +23,9 @@
 // update_memory_map(data);
 // 3. Register it
 // cpu->set_6510_port_callback(c64_banking_callback);
+// Or, instead of rebuilding the map in the callback, hand the core one page map
+// per port configuration and let a port write switch between them:
+// cpu->set_6510_memory_maps(c64_maps, 0x07);   // LORAM/HIRAM/CHAREN, 8 maps
 // -----------------------------------------------------------------------------
 
 // Notes
@@ -46,19 +49,51 @@
 // Passes most of the NES Lorentz Tests, the ones that don't apss I am still reviewing, it might have been my poor emulation.
 // Check back for updates.
 // Verified 6510 support with my new Commodore 64 Emulator, C64Emu-AI. 
+// 10/18/26 Added a page level memory map. Pages with no handlers go straight to memory, handler pages still
+// take the handler search exactly as before. Added breakpoints and watchpoints on top of it.
+// MEM and the handler tables are private now, set_memory/set_memory_handlers rebuild the map.
+// 10/18/26 Added peek/poke. The disassembler and debugger no longer call the live read handlers.
+// 10/18/26 Added always-on performance counters, read with get_counters(). Branches share branch6502().
+// 10/18/26 The core is now cpu_6502_core<Hooks>, a template over a hook policy (see cpu_6502_hooks.h).
+// cpu_6502 is the default policy, so existing code is unchanged. The debug trace and the AAE timer
+// call moved out of step6502 into policies; enable_debug() needs cpu_6502_core<cpu6502_trace_hooks>.
+// 10/18/26 Added superinstructions: hot opcode pairs run as one fused handler inside exec6502.
+// Interrupts are still taken between the two halves, and cycles and hooks are per instruction.
+// 10/18/26 N and Z are evaluated lazily. P is packed again when exec6502/step6502 return.
+// 10/18/26 The model opcode tables are built once and shared, init6502 just picks one. The instruction
+// usage counts are allocated by enable_instruction_profile() and now actually count.
+// 10/18/26 Hot execution state is declared first in a 64 byte aligned object, cold state after it.
+// 10/18/26 Added a bus policy, cpu_6502_core<Hooks, Bus>. The default searches the handler tables as
+// before; a fixed board map (cpu_6502_bus.h) is resolved inline with direct calls to the board.
+// 10/18/26 Added map_memory/unmap_memory. Bank switches rewrite page map entries instead of copying.
+// 10/18/26 Added set_6510_memory_maps. A 6510 port write can switch between precomputed page maps.
+// 10/18/26 Opcode and operand fetches read through a cached pointer to PC's page.
+// 10/18/26 Read-modify-write instructions resolve their address once. Added the optional NMOS dummy write.
+// 10/18/26 Added dma_copy. Block transfers are passed a page at a time and stall the CPU for their cycles.
+// 10/18/26 Added RDY stall windows. exec6502 runs up to the next window and idles through it.
+// 10/18/26 Decimal mode ADC/SBC (and RRA/ISC) correct the binary result with a shared 4 KB table, built at
+// compile time and indexed by the result and the low digit carry.
+// 10/18/26 Superinstructions have their own bodies that read the sequence straight from the code page,
+// and INC zp/BNE also runs the INC zp+1 of a 16 bit increment. They are now off by default.
 
 #ifndef _6502_H_
 #define _6502_H_
 
 #pragma once
 
+#include <atomic>
 #include <cstdint>
 #include <string>
+#include <vector>
+#include <memory>
 #include "cpu_handler.h"
 
 // undefine USING_AAE_EMU to remove the timer code.
 //#define USING_AAE_EMU
 
+#include "cpu_6502_hooks.h"
+#include "cpu_6502_bus.h"
+
 enum irqmode
 {
 	IRQ_PULSE,
@@ -72,9 +107,140 @@ enum CpuModel {
 	CPU_6510
 };
 
-class cpu_6502
+// -----------------------------------------------------------------------------
+// Page level memory map.
+// Each entry points at the host byte that backs offset 0 of a 256 byte page, so
+// an access to that page is a single indexed load. A null entry sends the access
+// down the handler search (the slow path). Pages with handlers and unhandled
+// pages under mame_memory_handling are null unless map_memory put a bank there.
+// Pages holding watchpoints are always null in the map the access paths use.
+// -----------------------------------------------------------------------------
+struct cpu6502_memory_map
+{
+	uint8_t* read[256];
+	uint8_t* write[256];
+};
+
+// Why the debugger stopped the CPU.
+enum cpu6502_stop_reason
+{
+	STOP_NONE,
+	STOP_BREAKPOINT,
+	STOP_WATCH_READ,
+	STOP_WATCH_WRITE
+};
+
+// -----------------------------------------------------------------------------
+// Performance counters. Always on, each is a single increment on a path that
+// already runs. Read and optionally reset with cpu->get_counters().
+// -----------------------------------------------------------------------------
+struct cpu6502_counters
+{
+	// Most frequently updated first, they share a cache line in the core.
+	uint64_t instructions = 0;       // Instructions retired
+	uint64_t cycles = 0;             // Since the last reset, includes IRQ/NMI entry and stalls
+	uint64_t direct_accesses = 0;    // Served from memory: mapped page, pUserArea or MEM
+	uint64_t handler_calls = 0;      // memoryCall invocations
+	uint64_t branches_taken = 0;
+	uint64_t branches_not_taken = 0;
+	uint64_t page_cross_cycles = 0;  // Extra cycles from indexed and branch page crossings
+	uint64_t irqs_deferred = 0;      // Instructions run with an IRQ held off by CLI/PLP/RTI delay
+	uint64_t irqs = 0;               // IRQs taken
+	uint64_t nmis = 0;               // NMIs taken
+	uint64_t unhandled = 0;          // No handler and mame_memory_handling on
+	uint64_t stall_cycles = 0;       // Cycles the CPU was halted by DMA or RDY
+};
+
+struct cpu6502_stop_info
+{
+	cpu6502_stop_reason reason = STOP_NONE;
+	int id = 0;        // Breakpoint or watchpoint that fired
+	uint16_t addr = 0; // Execute address or accessed address
+	uint8_t data = 0;  // Opcode, or the byte read/written
+	uint16_t pc = 0;   // PC of the instruction that caused the stop
+};
+
+// -----------------------------------------------------------------------------
+// Tables shared by every hook policy.
+// -----------------------------------------------------------------------------
+struct cpu6502_tables
 {
+	static const char* const mnemonics[256];
+	static const uint32_t ticks[256];
+
+	// Decimal mode ADC/SBC. Indexed by the binary result's low 9 bits plus, in
+	// bit 9, the carry (ADC) or borrow (SBC) out of the low digit, which is bit
+	// 4 of A ^ M ^ result. Holds the corrected result and the carry out; N, V
+	// and Z come from the binary or decimal result as each model wants.
+	struct bcd_result
+	{
+		uint8_t value, carry;
+	};
+	struct bcd_table
+	{
+		bcd_result entry[1024];
+	};
+	static const bcd_table bcd_adc;
+	static const bcd_table bcd_sbc;
+};
+
+template <class Hooks = cpu6502_default_hooks, class Bus = cpu6502_handler_bus>
+class alignas(64) cpu_6502_core : public cpu6502_tables
+{
+	// -------------------------------------------------------------------------
+	// Hot state. Everything the execute loop touches on every instruction is
+	// declared first, so it fills the first cache line of the (64 byte aligned)
+	// object: registers, operand scratch, cycle counts, IRQ lines and the two
+	// dispatch pointers. The counters and the fused pair index take the next
+	// lines. Cold state (handler tables, 6510 port, debugger) comes after the
+	// interface. bench/cpu_6502_bench.cpp measures the effect.
+	// -------------------------------------------------------------------------
+	struct OpEntry;
+
+public:
+	uint8_t A = 0, X = 0, Y = 0, S = 0xFF;
+	uint16_t PC = 0, PPC = 0;
+
+private:
+	// N and Z are kept apart from P while exec6502 or step6502 runs (see set_nz),
+	// so P is private. Read and write it with m6502_get_reg/m6502_set_reg(M6502_P).
+	uint8_t P = 0;
+	uint8_t opcode = 0;
+	uint8_t value = 0, saveflags = 0;
+	uint8_t irq_inhibit_one = 0;
+	uint8_t flag_n = 0;        // Lazy N and Z, see set_nz
+	uint8_t flag_z = 1;
+	bool flags_live = false;
+	uint16_t addrmask = 0;
+	uint16_t savepc = 0, oldpc = 0, reladdr = 0, help = 0;
+
+	int clockticks6502 = 0;
+	int clocktickstotal = 0;
+	int _irqMode = 0;
+	int _irqPending = 0;
+
+	// 'map' is what the access paths use: normally base, or the debugger's
+	// trap map while watchpoints are set. opcode_table is the model's shared table.
+	const cpu6502_memory_map* map = &base_map;
+	const OpEntry* opcode_table = nullptr;
+
+	// Read pointer for the page PC is on, see code_read. Any change to 'map'
+	// sets code_page_index to 0x100, which no page matches.
+	const uint8_t* code_page = nullptr;
+	uint16_t code_page_index = 0x100;
+
+	cpu6502_counters counters;
+	const uint8_t* fused_first = nullptr;
+	CpuModel cpu_model = CPU_NMOS_6502;
+	bool superinstructions = false;
+	bool rmw_dummy_write = false;
+
 public:
+	// Hook policy instance, for policies that keep state.
+	Hooks hooks;
+	// Bus policy instance, the board for a fixed bus (see cpu_6502_bus.h).
+	Bus bus;
+
 	enum
 	{
 		M6502_A = 0x01,
@@ -86,16 +252,26 @@ public:
 
 	// -------------------------------------------------------------------------
 	// External memory interface
+	// The page map points into MEM and is built from the handler tables, so
+	// both are changed through the setters, which rebuild it. A table edited in
+	// place needs rebuild_memory_map() as well.
 	// -------------------------------------------------------------------------
-	uint8_t* MEM = nullptr;
-	MemoryReadByte* memory_read = nullptr;
-	MemoryWriteByte* memory_write = nullptr;
+	void set_memory(uint8_t* mem) { MEM = mem; rebuild_memory_map(); }
+	void set_memory_handlers(MemoryReadByte* read_mem, MemoryWriteByte* write_mem)
+	{
+		memory_read = read_mem;
+		memory_write = write_mem;
+		rebuild_memory_map();
+	}
+	uint8_t* get_memory() const { return MEM; }
+	const MemoryReadByte* get_read_handlers() const { return memory_read; }
+	const MemoryWriteByte* get_write_handlers() const { return memory_write; }
 
 	// -------------------------------------------------------------------------
 	// Construction and execution
 	// -------------------------------------------------------------------------
-	cpu_6502(uint8_t* mem, MemoryReadByte* read_mem, MemoryWriteByte* write_mem, uint16_t addr, int num, CpuModel model = CPU_NMOS_6502);
-	~cpu_6502() = default;
+	cpu_6502_core(uint8_t* mem, MemoryReadByte* read_mem, MemoryWriteByte* write_mem, uint16_t addr, int num, CpuModel model = CPU_NMOS_6502);
+	~cpu_6502_core() = default;
 
 	void init6502(uint16_t addrmaskval, CpuModel model = CPU_NMOS_6502);
 	void reset6502();
@@ -105,6 +281,22 @@ public:
 	int exec6502(int timerTicks);
 	int step6502();
 	int get6502ticks(int reset);
+	cpu6502_counters get_counters(bool reset = false);
+	// Monotonic cycle clock, never reset by get_counters(). Includes IRQ/NMI
+	// entry and stalls. The RDY and DMA timing and the Chrome trace use it.
+	uint64_t get_cycles() const { return cycle_base + counters.cycles; }
+
+	// Fused instruction sequences in exec6502's normal loop, off by default.
+	// On the bench's mixed loop they are within noise of plain dispatch, on
+	// code made of the fused idioms about 25% faster. Turn them on where
+	// cpu6502_sequence_hooks shows those pairs are hot; the bench
+	// (bench/cpu_6502_bench.cpp) prints both.
+	void enable_superinstructions(bool s) { superinstructions = s; }
+
+	// NMOS read-modify-write instructions write the unmodified value back before
+	// the result. Only a write handler can tell, so it is off by default; turn it
+	// on for hardware that reacts to it. The 65C02 never does the dummy write.
+	void enable_rmw_dummy_write(bool s) { rmw_dummy_write = s; }
 
 	// 2. Add a callback setter for the 6510 Port
 	// The emulator calls this to set a function that triggers when the port changes.
@@ -112,14 +304,22 @@ public:
 	void set_6510_port_callback(PortCallback cb) { port_cb = cb; }
 
 	// Allow the emulator to set input pins (like cassette sense)
-	void set_6510_port_in(uint8_t val) { port_in = val; }
+	void set_6510_port_in(uint8_t val) { port_in = val; select_6510_map(); }
+
+	// Precomputed memory configurations, such as the C64's LORAM/HIRAM/CHAREN
+	// banking. maps[i] is used while the port pins & mask equal i, so mask must be
+	// 2^n - 1 and maps must hold mask + 1 entries. A port write that changes the
+	// pins switches the active map with one pointer swap. The maps are copied,
+	// page 0 always stays with the port, and map_memory edits the active one.
+	// Null maps go back to the single map built by rebuild_memory_map().
+	bool set_6510_memory_maps(const cpu6502_memory_map* maps, uint8_t mask);
 
 	// -------------------------------------------------------------------------
 	// Instruction Usage Profiler
+	// The counts are only allocated while the profiler is enabled.
 	// -------------------------------------------------------------------------
-	uint64_t instruction_count[256] = { 0 };
-	bool instruction_profile_enabled = false;
-
+	void enable_instruction_profile(bool s);
+	bool instruction_profile_enabled() const { return instruction_count != nullptr; }
 	void log_instruction_usage();
 	void reset_instruction_counts();
 
@@ -138,15 +338,116 @@ public:
 	void m6502clearpendingint();
 	void check_interrupts_after_cli();
 	bool is_irq_pending() const { return _irqPending != 0; }
+	int get_cpu_num() const { return cpu_num; }
 
 	// -------------------------------------------------------------------------
 	// Debugging and disassembly
 	// -------------------------------------------------------------------------
-	void enable_debug(bool s) { debug = s; }
-	void mame_memory_handling(bool s) { mmem = s; }
+	// The trace is printed by the hook policy (cpu6502_trace_hooks). Policies
+	// that can't trace keep the flag but log an error the first time it is set.
+	void enable_debug(bool s)
+	{
+		debug = s;
+		if constexpr (!Hooks::traces)
+		{
+			static std::atomic<bool> warned{ false };
+			if (s && !warned.exchange(true))
+				LOG_ERROR("enable_debug: this CPU's hook policy has no trace, use cpu_6502_core<cpu6502_trace_hooks>");
+		}
+	}
+	bool debug_enabled() const { return debug; }
+	void mame_memory_handling(bool s) { mmem = s; rebuild_memory_map(); }
 	void log_unhandled_rw(bool s) { log_debug_rw = s; }
 	std::string disassemble(uint16_t pc, int* bytesUsed = nullptr);
 
+	// -------------------------------------------------------------------------
+	// Memory map
+	// Call rebuild_memory_map() after editing a handler table in place.
+	// -------------------------------------------------------------------------
+	void rebuild_memory_map();
+	const cpu6502_memory_map& get_memory_map() const { return *base; }
+
+	// -------------------------------------------------------------------------
+	// Bank switching
+	// map_memory points whole pages at a host buffer by rewriting their map
+	// entries, so switching a bank costs one pointer per page instead of a copy.
+	// The pages are then plain memory, their handlers are not called. unmap_memory
+	// sends pages back to the handlers. rebuild_memory_map() undoes both.
+	// addr and size must be multiples of 256, and addr is after addrmask.
+	// -------------------------------------------------------------------------
+	enum
+	{
+		MAP_READ = 0x01,
+		MAP_WRITE = 0x02
+	};
+
+	bool map_memory(uint16_t addr, uint32_t size, uint8_t* host, int flags = MAP_READ | MAP_WRITE);
+	bool unmap_memory(uint16_t addr, uint32_t size, int flags = MAP_READ | MAP_WRITE);
+
+	// -------------------------------------------------------------------------
+	// DMA
+	// dma_copy reads len bytes from src on the CPU's bus and passes them to dst
+	// in blocks that never cross a page. A mapped page is passed straight from
+	// memory, so a sink that memcpys does one copy per page; other pages are read
+	// through their handlers into a buffer first. on_read doesn't see DMA reads.
+	// The CPU is then stalled for 'stall' cycles, or with -1 for the model's own
+	// timing: on the 2A03 two cycles per byte plus one, and one more from an odd
+	// cycle (513 or 514 for sprite DMA), elsewhere one cycle per byte. Called
+	// from a write handler the stall is added to the instruction that wrote,
+	// otherwise it is taken before the next one. Returns the stall.
+	//
+	//   static void oam_dma(const uint8_t* data, int len, void* ppu) { ... }
+	//   // $4014 write handler
+	//   cpu->dma_copy(data << 8, oam_dma, ppu, 256);
+	// -------------------------------------------------------------------------
+	typedef void (*DmaSink)(const uint8_t* data, int len, void* user);
+	int dma_copy(uint16_t src, DmaSink dst, void* user, int len, int stall = -1);
+
+	// -------------------------------------------------------------------------
+	// RDY line
+	// add_rdy_stall pulls RDY low for 'cycles' cycles from cycle 'at' on the
+	// get_cycles() timeline, for cycle stealing such as C64 badlines. exec6502
+	// runs up to the first instruction boundary at or after 'at' and then idles
+	// for the whole window, which is where an instruction that ran into it would
+	// have finished. There is no per-instruction check: without windows the loop
+	// is unchanged, with them it is split at each window. A window longer than
+	// the rest of the budget carries over to the next call. Windows should not
+	// overlap, each one is a separate stall. clear_rdy_stalls drops them all.
+	// -------------------------------------------------------------------------
+	bool add_rdy_stall(uint64_t at, int cycles);
+	void clear_rdy_stalls() { rdy_stalls.clear(); }
+
+	// -------------------------------------------------------------------------
+	// Debug memory access for tools. Never calls a read or write handler and
+	// never fires hooks or watchpoints. peek uses a handler's debugCall if it
+	// has one, poke only changes backing memory (RAM, ROM or pUserArea).
+	// -------------------------------------------------------------------------
+	uint8_t peek(uint16_t addr) const;
+	void poke(uint16_t addr, uint8_t byte);
+
+	// -------------------------------------------------------------------------
+	// Breakpoints and watchpoints
+	// With none set, exec6502 runs the normal loop and checks nothing. Setting one
+	// flags its page: execute pages are checked before each instruction, and read
+	// or write pages are unmapped so their accesses take the slow path.
+	// A condition callback, if given, decides whether a hit actually stops.
+	// While stopped, exec6502 returns 0 without executing until resume().
+	// -------------------------------------------------------------------------
+	enum
+	{
+		WATCH_READ = 0x01,
+		WATCH_WRITE = 0x02
+	};
+	typedef bool (*BreakCondition)(cpu_6502_core* cpu, uint16_t addr, uint8_t data, void* user);
+
+	int add_breakpoint(uint16_t addr, BreakCondition cond = nullptr, void* user = nullptr);
+	int add_watchpoint(uint16_t lo, uint16_t hi, int flags, BreakCondition cond = nullptr, void* user = nullptr);
+	void remove_breakpoint(int id);
+	void clear_breakpoints();
+	bool is_stopped() const { return dbg && dbg->stop.reason != STOP_NONE; }
+	const cpu6502_stop_info& get_stop_info() const;
+	void resume();
+
 	// -------------------------------------------------------------------------
 	// Stack operations
 	// -------------------------------------------------------------------------
@@ -155,32 +456,23 @@ public:
 	uint16_t pull16();
 	uint8_t pull8();
 
-	uint8_t A = 0, P = 0, X = 0, Y = 0, S = 0xFF;
-	uint16_t PC = 0, PPC = 0;
-
 private:
-	// Store the model
-	CpuModel cpu_model = CPU_NMOS_6502;
 	// -------------------------------------------------------------------------
-	// CPU internal flags and registers
+	// CPU internal flags and registers (cold, the hot ones are at the top)
 	// -------------------------------------------------------------------------
 	bool direct_zero_page = false;
 	bool direct_stack_page = false;
-	// -------------------------------------------------------------------------
-	// CPU internal state
-	// -------------------------------------------------------------------------
-	uint16_t addrmask = 0;
-	uint8_t opcode = 0;
-	uint16_t savepc = 0, oldpc = 0, reladdr = 0, help = 0;
-	uint8_t value = 0, saveflags = 0;
-
-	int clockticks6502 = 0;
-	int clocktickstotal = 0;
-	// IRQ Handling
-	int _irqMode = 0;
-	int _irqPending = 0;
-	uint8_t irq_inhibit_one = 0;
 	int cpu_num = 0;
+	uint64_t cycle_base = 0; // Cycles dropped from counters.cycles by get_counters(true)
+	int stall_pending = 0; // DMA stall started outside exec6502/step6502
+
+	// RDY windows still to come, sorted by start cycle
+	struct RdyStall
+	{
+		uint64_t at;
+		int cycles;
+	};
+	std::vector<RdyStall> rdy_stalls;
 
 	bool debug = false;
 	bool mmem = false;
@@ -197,6 +489,59 @@ private:
 	// Helper to check for changes
 	void check_and_notify_6510(uint8_t old_ddr, uint8_t old_port);
 
+	// Port configuration maps, empty unless set_6510_memory_maps was called
+	std::vector<cpu6502_memory_map> port_maps;
+	uint8_t port_map_mask = 0;
+	void select_6510_map();
+
+	// Backing image and handler tables, see set_memory/set_memory_handlers
+	uint8_t* MEM = nullptr;
+	MemoryReadByte* memory_read = nullptr;
+	MemoryWriteByte* memory_write = nullptr;
+
+	// -------------------------------------------------------------------------
+	// Memory map state. The active 'map' pointer is in the hot block. 'base' is
+	// the map in force without watchpoints: base_map, or a 6510 port map.
+	// -------------------------------------------------------------------------
+	cpu6502_memory_map base_map = {};
+	cpu6502_memory_map* base = &base_map;
+
+	// -------------------------------------------------------------------------
+	// Debugger state, only allocated while breakpoints exist.
+	// -------------------------------------------------------------------------
+	enum
+	{
+		TRAP_EXEC = 0x01,
+		TRAP_READ = 0x02,
+		TRAP_WRITE = 0x04
+	};
+
+	struct Breakpoint
+	{
+		int id;
+		uint16_t lo, hi;
+		int flags; // TRAP_xxx
+		BreakCondition cond;
+		void* user;
+	};
+
+	struct DebugState
+	{
+		std::vector<Breakpoint> points;
+		uint8_t trap_flags[256] = {};
+		cpu6502_memory_map trap_map = {};
+		cpu6502_stop_info stop;
+		int next_id = 1;
+		bool skip_break_once = false;
+	};
+	std::unique_ptr<DebugState> dbg;
+
+	void update_traps();
+	bool check_breakpoint(uint16_t addr);
+	int rescan_index(int i, int id) const;
+	void check_watchpoints(uint16_t addr, uint8_t data, int flag);
+	int exec6502_debug(int timerTicks);
+
 	// -------------------------------------------------------------------------
 	// Processor status flags
 	// -------------------------------------------------------------------------
@@ -218,10 +563,42 @@ private:
 	static constexpr uint16_t BASE_STACK = 0x100;
 
 	// -------------------------------------------------------------------------
-	// Memory access
+	// Memory access. get/put6502memory call the hooks, bus_read/bus_write don't.
 	// -------------------------------------------------------------------------
 	uint8_t get6502memory(uint16_t addr);
 	void put6502memory(uint16_t addr, uint8_t byte);
+	uint8_t bus_read(uint16_t addr);
+	void bus_write(uint16_t addr, uint8_t byte);
+	uint8_t* debug_location(uint16_t addr) const;
+	uint8_t read_slow(uint16_t addr);
+	void write_slow(uint16_t addr, uint8_t byte);
+
+	// Opcode and operand fetch through the cached code page. fetch8 reads the
+	// byte at PC and advances it, fetch16 reads PC and PC + 1 and leaves PC.
+	// Operand bytes still fire on_read, the opcode byte doesn't.
+	uint8_t code_read(uint16_t addr);
+	uint8_t fetch8();
+	uint16_t fetch16();
+	void flush_code_page() { code_page_index = 0x100; }
+
+	// Read-modify-write. rmw_read resolves savepc once and hands the write side
+	// the byte to store to when the read came straight from a mapped page, so
+	// the write skips the mask and the map. Anything else writes through
+	// put6502memory. Hooks and watchpoints see both accesses as before.
+	struct RmwAccess
+	{
+		uint8_t data;    // The value read
+		uint8_t* direct; // Where the result goes, or null
+	};
+	RmwAccess rmw_read();
+	void rmw_write(const RmwAccess& m, uint8_t byte);
+
+	// Stalls between instructions. idle6502 adds the cycles to the counts and
+	// calls on_stall. take_stall idles for stall_pending, take_rdy for the first
+	// RDY window, at most 'limit' cycles of it. Both return the cycles idled.
+	void idle6502(int cycles);
+	int take_stall();
+	int take_rdy(int limit);
 
 	// -------------------------------------------------------------------------
 	// IRQ helper
@@ -230,21 +607,68 @@ private:
 
 	// -------------------------------------------------------------------------
 	// Inline flag logic
+	// N and Z are lazy: instructions store the byte they come from, and they are
+	// only worked out when something reads the whole of P. N is bit 7 of flag_n,
+	// Z is set when flag_z is zero. P's own N and Z bits are stale while
+	// flags_live is set, which is from entry to exit of exec6502/step6502.
 	// -------------------------------------------------------------------------
 	inline void set_nz(uint8_t n)
 	{
-		if (n == 0)
-			P = (P & ~F_N) | F_Z;
+		flag_n = n;
+		flag_z = n;
+	}
+
+	inline uint8_t get_p() const
+	{
+		if (!flags_live)
+			return P;
+		return (P & ~(F_N | F_Z)) | (flag_n & F_N) | (flag_z ? 0 : F_Z);
+	}
+
+	// Valid live or not, the flags are reloaded from P at the next entry anyway.
+	inline void set_p(uint8_t v)
+	{
+		P = v;
+		flag_n = v;
+		flag_z = (v & F_Z) ? 0 : 1;
+	}
+
+	inline void unpack_flags()
+	{
+		set_p(P);
+		flags_live = true;
+	}
+
+	inline void pack_flags()
+	{
+		P = get_p();
+		flags_live = false;
+	}
+
+	// Conditional branch. +1 cycle if taken, +1 more if it crosses a page.
+	inline void branch6502(bool taken)
+	{
+		if (!taken)
+		{
+			counters.branches_not_taken++;
+			return;
+		}
+
+		oldpc = PC;
+		PC += (int8_t)savepc;
+		counters.branches_taken++;
+		if ((oldpc ^ PC) & 0xFF00)
+		{
+			clockticks6502 += 2;
+			counters.page_cross_cycles++;
+		}
 		else
-			P = (P & ~(F_N | F_Z)) | (n & F_N);
+			clockticks6502++;
 	}
 
 	inline void set_z(uint8_t n)
 	{
-		if (n == 0)
-			P |= F_Z;
-		else
-			P &= ~F_Z;
+		flag_z = n;
 	}
 
 	// -------------------------------------------------------------------------
@@ -252,14 +676,65 @@ private:
 	// -------------------------------------------------------------------------
 
 	struct OpEntry {
-		void (cpu_6502::* instruction)();
-		void (cpu_6502::* addressing_mode)();
+		void (cpu_6502_core::* instruction)();
+		void (cpu_6502_core::* addressing_mode)();
 	};
-	OpEntry opcode_table[256]; // The instance table
 
-	// ADD THIS LINE HERE:
+	// Master table, every variant. Each model's table is a patched copy of it.
 	static const OpEntry initial_opcode_table[256];
 
+	// -------------------------------------------------------------------------
+	// Superinstructions. Common sequences (CMP #/BNE, DEX/BNE, LDA/STA and the
+	// INC zp/BNE/INC zp+1 16 bit increment) are recognised before dispatch.
+	// The handler gets a pointer to the sequence's bytes on the mapped code page
+	// and runs it as one body.
+	// -------------------------------------------------------------------------
+	struct FusedPair {
+		uint8_t first, second;
+		uint8_t length; // Bytes in the first instruction
+		uint8_t size;   // Bytes in both
+		int (cpu_6502_core::* handler)(const uint8_t* code, int budget);
+	};
+	static const FusedPair fused_pairs[];
+
+	enum { FUSED_A, FUSED_X, FUSED_Y };     // Register operand
+	enum { FUSED_IMM, FUSED_ZP, FUSED_ABS }; // Memory operand
+
+	// -------------------------------------------------------------------------
+	// Per model tables, built once and shared by every instance. An instance
+	// only points at the ones for its model.
+	// -------------------------------------------------------------------------
+	struct ModelTables {
+		OpEntry ops[256];
+		// 1 + index of the first fused_pairs entry for this opcode, 0 if it never starts a pair.
+		uint8_t fused_first[256];
+	};
+
+	static const ModelTables& model_tables(CpuModel model);
+	static void build_opcode_table(CpuModel model, OpEntry* opcode_table);
+	static void build_fused_table(ModelTables& tables);
+
+	// Instruction usage counts, null unless the profiler is enabled.
+	std::unique_ptr<uint64_t[]> instruction_count;
+
+	int execute_instruction();
+	int exec_slice(int budget);
+	int exec6502_rdy(int budget);
+	int step6502_fused(int budget);
+	template <int Reg, bool Equal> int fused_cmp_branch(const uint8_t* code, int budget);
+	template <int Reg> int fused_dec_bne(const uint8_t* code, int budget);
+	template <int Load, int Store> int fused_load_store(const uint8_t* code, int budget);
+	int fused_inc_bne(const uint8_t* code, int budget);
+	void fused_fetch(uint16_t pc, uint8_t op);
+	template <int Mode> uint16_t fused_address(const uint8_t* code, uint16_t pc);
+	template <int Mode> uint8_t fused_load(const uint8_t* code, uint16_t pc);
+	template <int Reg> uint8_t& fused_reg();
+	int fused_retire(uint16_t pc, int length);
+	bool fused_stop(int cycles, int budget, uint8_t next, uint8_t expected) const;
+	int fused_branch(const uint8_t* code, uint16_t pc, bool taken);
+	int fused_inc_zp(const uint8_t* code, uint16_t pc);
+	void retire6502(uint16_t pc);
+
 	// -------------------------------------------------------------------------
 	// Addressing modes
 	// -------------------------------------------------------------------------
@@ -311,4 +786,15 @@ private:
 	void bbr_bbs_6502(); // Handles BBR0-7 and BBS0-7
 };
 
+#include "cpu_6502.inl"
+
+// The stock policies are compiled once, in cpu_6502.cpp.
+extern template class cpu_6502_core<cpu6502_null_hooks>;
+extern template class cpu_6502_core<cpu6502_trace_hooks>;
+#ifdef USING_AAE_EMU
+extern template class cpu_6502_core<cpu6502_aae_timer_hooks>;
+#endif
+
+typedef cpu_6502_core<> cpu_6502;
+
 #endif // _6502_H_
\ No newline at end of file
@@ -0,0 +1,3892 @@
+// -----------------------------------------------------------------------------
+// AAE (Another Arcade Emulator) - 6502 CPU Core
+//
+// This file is part of the AAE project and is released under The Unlicense.
+// You are free to use, modify, and distribute this software without restriction.
+// See <http://unlicense.org/> for details.
+//
+// Member definitions for cpu_6502_core<Hooks, Bus>. Included from cpu_6502.h only.
+// -----------------------------------------------------------------------------
+
+#include <stdio.h>
+#include <cstring> // Required for memcpy
+#include <algorithm>
+#include "sys_log.h"
+
+// -----------------------------------------------------------------------------
+// Initial Opcode Table
+// Contains NMOS Official, NMOS Illegal, and CMOS Official instructions.
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+const typename cpu_6502_core<Hooks, Bus>::OpEntry cpu_6502_core<Hooks, Bus>::initial_opcode_table[256] = {
+	{ &cpu_6502_core::brk6502, &cpu_6502_core::implied6502 },   // 0x00
+	{ &cpu_6502_core::ora6502, &cpu_6502_core::indx6502    },   // 0x01
+	{ &cpu_6502_core::nop6502, &cpu_6502_core::implied6502 },   // 0x02
+	{ &cpu_6502_core::slo6502, &cpu_6502_core::indx6502    },   // 0x03 (UNDOC)
+	{ &cpu_6502_core::tsb6502, &cpu_6502_core::zp6502      },   // 0x04 (CMOS)
+	{ &cpu_6502_core::ora6502, &cpu_6502_core::zp6502      },   // 0x05
+	{ &cpu_6502_core::asl6502, &cpu_6502_core::zp6502      },   // 0x06
+	{ &cpu_6502_core::slo6502, &cpu_6502_core::zp6502      },   // 0x07 (UNDOC)
+	{ &cpu_6502_core::php6502, &cpu_6502_core::implied6502 },   // 0x08
+	{ &cpu_6502_core::ora6502, &cpu_6502_core::immediate6502 }, // 0x09
+	{ &cpu_6502_core::asla6502, &cpu_6502_core::implied6502 },  // 0x0A
+	{ &cpu_6502_core::anc6502, &cpu_6502_core::immediate6502 }, // 0x0B (UNDOC)
+	{ &cpu_6502_core::tsb6502, &cpu_6502_core::abs6502     },   // 0x0C (CMOS)
+	{ &cpu_6502_core::ora6502, &cpu_6502_core::abs6502     },   // 0x0D
+	{ &cpu_6502_core::asl6502, &cpu_6502_core::abs6502     },   // 0x0E
+	{ &cpu_6502_core::slo6502, &cpu_6502_core::abs6502     },   // 0x0F (UNDOC)
+	{ &cpu_6502_core::bpl6502, &cpu_6502_core::relative6502 },  // 0x10
+	{ &cpu_6502_core::ora6502, &cpu_6502_core::indy6502    },   // 0x11
+	{ &cpu_6502_core::ora6502, &cpu_6502_core::indzp6502   },   // 0x12 (CMOS)
+	{ &cpu_6502_core::slo6502, &cpu_6502_core::indy6502    },   // 0x13 SLO (ind),Y (UNDOC)
+	{ &cpu_6502_core::trb6502, &cpu_6502_core::zp6502      },   // 0x14 (CMOS)
+	{ &cpu_6502_core::ora6502, &cpu_6502_core::zpx6502     },   // 0x15
+	{ &cpu_6502_core::asl6502, &cpu_6502_core::zpx6502     },   // 0x16
+	{ &cpu_6502_core::slo6502, &cpu_6502_core::zpx6502     },   // 0x17 (UNDOC)
+	{ &cpu_6502_core::clc6502, &cpu_6502_core::implied6502 },   // 0x18
+	{ &cpu_6502_core::ora6502, &cpu_6502_core::absy6502    },   // 0x19
+	{ &cpu_6502_core::ina6502, &cpu_6502_core::implied6502 },   // 0x1A (CMOS)
+	{ &cpu_6502_core::slo6502, &cpu_6502_core::absy6502    },   // 0x1B (UNDOC)
+	{ &cpu_6502_core::trb6502, &cpu_6502_core::abs6502     },   // 0x1C (CMOS)
+	{ &cpu_6502_core::ora6502, &cpu_6502_core::absx6502    },   // 0x1D
+	{ &cpu_6502_core::asl6502, &cpu_6502_core::absx6502    },   // 0x1E
+	{ &cpu_6502_core::slo6502, &cpu_6502_core::absx6502    },   // 0x1F (UNDOC)
+	{ &cpu_6502_core::jsr6502, &cpu_6502_core::abs6502     },   // 0x20
+	{ &cpu_6502_core::and6502, &cpu_6502_core::indx6502    },   // 0x21
+	{ &cpu_6502_core::nop6502, &cpu_6502_core::implied6502 },   // 0x22
+	{ &cpu_6502_core::rla6502, &cpu_6502_core::indx6502    },   // 0x23 (UNDOC)
+	{ &cpu_6502_core::bit6502, &cpu_6502_core::zp6502      },   // 0x24
+	{ &cpu_6502_core::and6502, &cpu_6502_core::zp6502      },   // 0x25
+	{ &cpu_6502_core::rol6502, &cpu_6502_core::zp6502      },   // 0x26
+	{ &cpu_6502_core::rla6502, &cpu_6502_core::zp6502      },   // 0x27 (UNDOC)
+	{ &cpu_6502_core::plp6502, &cpu_6502_core::implied6502 },   // 0x28
+	{ &cpu_6502_core::and6502, &cpu_6502_core::immediate6502 }, // 0x29
+	{ &cpu_6502_core::rola6502, &cpu_6502_core::implied6502 },  // 0x2A
+	{ &cpu_6502_core::anc6502, &cpu_6502_core::immediate6502 }, // 0x2B (UNDOC)
+	{ &cpu_6502_core::bit6502, &cpu_6502_core::abs6502     },   // 0x2C
+	{ &cpu_6502_core::and6502, &cpu_6502_core::abs6502     },   // 0x2D
+	{ &cpu_6502_core::rol6502, &cpu_6502_core::abs6502     },   // 0x2E
+	{ &cpu_6502_core::rla6502, &cpu_6502_core::abs6502     },   // 0x2F (UNDOC)
+	{ &cpu_6502_core::bmi6502, &cpu_6502_core::relative6502 },  // 0x30
+	{ &cpu_6502_core::and6502, &cpu_6502_core::indy6502    },   // 0x31
+	{ &cpu_6502_core::and6502, &cpu_6502_core::indzp6502   },   // 0x32 (CMOS)
+	{ &cpu_6502_core::rla6502, &cpu_6502_core::indy6502    },   // 0x33 RLA (ind),Y (UNDOC)
+	{ &cpu_6502_core::bit6502, &cpu_6502_core::zpx6502     },   // 0x34 (CMOS uses this, NMOS UNDOC)
+	{ &cpu_6502_core::and6502, &cpu_6502_core::zpx6502     },   // 0x35
+	{ &cpu_6502_core::rol6502, &cpu_6502_core::zpx6502     },   // 0x36
+	{ &cpu_6502_core::rla6502, &cpu_6502_core::zpx6502     },   // 0x37 (UNDOC)
+	{ &cpu_6502_core::sec6502, &cpu_6502_core::implied6502 },   // 0x38
+	{ &cpu_6502_core::and6502, &cpu_6502_core::absy6502    },   // 0x39
+	{ &cpu_6502_core::dea6502, &cpu_6502_core::implied6502 },   // 0x3A (CMOS)
+	{ &cpu_6502_core::rla6502, &cpu_6502_core::absy6502    },   // 0x3B (UNDOC)
+	{ &cpu_6502_core::bit6502, &cpu_6502_core::absx6502    },   // 0x3C (CMOS uses this, NMOS UNDOC)
+	{ &cpu_6502_core::and6502, &cpu_6502_core::absx6502    },   // 0x3D
+	{ &cpu_6502_core::rol6502, &cpu_6502_core::absx6502    },   // 0x3E
+	{ &cpu_6502_core::rla6502, &cpu_6502_core::absx6502    },   // 0x3F (UNDOC)
+	{ &cpu_6502_core::rti6502, &cpu_6502_core::implied6502 },   // 0x40
+	{ &cpu_6502_core::eor6502, &cpu_6502_core::indx6502    },   // 0x41
+	{ &cpu_6502_core::nop6502, &cpu_6502_core::implied6502 },   // 0x42
+	{ &cpu_6502_core::sre6502, &cpu_6502_core::indx6502    },   // 0x43 (UNDOC)
+	{ &cpu_6502_core::nop6502, &cpu_6502_core::implied6502 },   // 0x44
+	{ &cpu_6502_core::eor6502, &cpu_6502_core::zp6502      },   // 0x45
+	{ &cpu_6502_core::lsr6502, &cpu_6502_core::zp6502      },   // 0x46
+	{ &cpu_6502_core::sre6502, &cpu_6502_core::zp6502      },   // 0x47 (UNDOC)
+	{ &cpu_6502_core::pha6502, &cpu_6502_core::implied6502 },   // 0x48
+	{ &cpu_6502_core::eor6502, &cpu_6502_core::immediate6502 }, // 0x49
+	{ &cpu_6502_core::lsra6502, &cpu_6502_core::implied6502 },  // 0x4A
+	{ &cpu_6502_core::alr6502, &cpu_6502_core::immediate6502 }, // 0x4B (UNDOC)
+	{ &cpu_6502_core::jmp6502, &cpu_6502_core::abs6502     },   // 0x4C
+	{ &cpu_6502_core::eor6502, &cpu_6502_core::abs6502     },   // 0x4D
+	{ &cpu_6502_core::lsr6502, &cpu_6502_core::abs6502     },   // 0x4E
+	{ &cpu_6502_core::sre6502, &cpu_6502_core::abs6502     },   // 0x4F (UNDOC)
+	{ &cpu_6502_core::bvc6502, &cpu_6502_core::relative6502 },  // 0x50
+	{ &cpu_6502_core::eor6502, &cpu_6502_core::indy6502    },   // 0x51
+	{ &cpu_6502_core::eor6502, &cpu_6502_core::indzp6502   },   // 0x52 (CMOS)
+	{ &cpu_6502_core::sre6502, &cpu_6502_core::indy6502    },   // 0x53 SRE (ind),Y (UNDOC)
+	{ &cpu_6502_core::nop6502, &cpu_6502_core::implied6502 },   // 0x54
+	{ &cpu_6502_core::eor6502, &cpu_6502_core::zpx6502     },   // 0x55
+	{ &cpu_6502_core::lsr6502, &cpu_6502_core::zpx6502     },   // 0x56
+	{ &cpu_6502_core::sre6502, &cpu_6502_core::zpx6502     },   // 0x57 (UNDOC)
+	{ &cpu_6502_core::cli6502, &cpu_6502_core::implied6502 },   // 0x58
+	{ &cpu_6502_core::eor6502, &cpu_6502_core::absy6502    },   // 0x59
+	{ &cpu_6502_core::phy6502, &cpu_6502_core::implied6502 },   // 0x5A (CMOS)
+	{ &cpu_6502_core::sre6502, &cpu_6502_core::absy6502    },   // 0x5B (UNDOC)
+	{ &cpu_6502_core::nop6502, &cpu_6502_core::implied6502 },   // 0x5C
+	{ &cpu_6502_core::eor6502, &cpu_6502_core::absx6502    },   // 0x5D
+	{ &cpu_6502_core::lsr6502, &cpu_6502_core::absx6502    },   // 0x5E
+	{ &cpu_6502_core::sre6502, &cpu_6502_core::absx6502    },   // 0x5F (UNDOC)
+	{ &cpu_6502_core::rts6502, &cpu_6502_core::implied6502 },   // 0x60
+	{ &cpu_6502_core::adc6502, &cpu_6502_core::indx6502    },   // 0x61
+	{ &cpu_6502_core::nop6502, &cpu_6502_core::implied6502 },   // 0x62
+	{ &cpu_6502_core::rra6502, &cpu_6502_core::indx6502    },   // 0x63 (UNDOC)
+	{ &cpu_6502_core::stz6502, &cpu_6502_core::zp6502      },   // 0x64 (CMOS)
+	{ &cpu_6502_core::adc6502, &cpu_6502_core::zp6502      },   // 0x65
+	{ &cpu_6502_core::ror6502, &cpu_6502_core::zp6502      },   // 0x66
+	{ &cpu_6502_core::rra6502, &cpu_6502_core::zp6502      },   // 0x67 (UNDOC)
+	{ &cpu_6502_core::pla6502, &cpu_6502_core::implied6502 },   // 0x68
+	{ &cpu_6502_core::adc6502, &cpu_6502_core::immediate6502 }, // 0x69
+	{ &cpu_6502_core::rora6502, &cpu_6502_core::implied6502 },  // 0x6A
+	{ &cpu_6502_core::arr6502, &cpu_6502_core::immediate6502 }, // 0x6B (UNDOC)
+	{ &cpu_6502_core::jmp6502, &cpu_6502_core::indirect6502 },  // 0x6C
+	{ &cpu_6502_core::adc6502, &cpu_6502_core::abs6502     },   // 0x6D
+	{ &cpu_6502_core::ror6502, &cpu_6502_core::abs6502     },   // 0x6E
+	{ &cpu_6502_core::rra6502, &cpu_6502_core::abs6502     },   // 0x6F (UNDOC)
+	{ &cpu_6502_core::bvs6502, &cpu_6502_core::relative6502 },  // 0x70
+	{ &cpu_6502_core::adc6502, &cpu_6502_core::indy6502    },   // 0x71
+	{ &cpu_6502_core::adc6502, &cpu_6502_core::indzp6502   },   // 0x72 (CMOS)
+	{ &cpu_6502_core::rra6502, &cpu_6502_core::indy6502    },   // 0x73 RRA (ind),Y (UNDOC)
+	{ &cpu_6502_core::stz6502, &cpu_6502_core::zpx6502     },   // 0x74 (CMOS)
+	{ &cpu_6502_core::adc6502, &cpu_6502_core::zpx6502     },   // 0x75
+	{ &cpu_6502_core::ror6502, &cpu_6502_core::zpx6502     },   // 0x76
+	{ &cpu_6502_core::rra6502, &cpu_6502_core::zpx6502     },   // 0x77 (UNDOC)
+	{ &cpu_6502_core::sei6502, &cpu_6502_core::implied6502 },   // 0x78
+	{ &cpu_6502_core::adc6502, &cpu_6502_core::absy6502    },   // 0x79
+	{ &cpu_6502_core::ply6502, &cpu_6502_core::implied6502 },   // 0x7A (CMOS)
+	{ &cpu_6502_core::rra6502, &cpu_6502_core::absy6502    },   // 0x7B (UNDOC)
+	{ &cpu_6502_core::jmp6502, &cpu_6502_core::indabsx6502 },   // 0x7C (CMOS)
+	{ &cpu_6502_core::adc6502, &cpu_6502_core::absx6502    },   // 0x7D
+	{ &cpu_6502_core::ror6502, &cpu_6502_core::absx6502    },   // 0x7E
+	{ &cpu_6502_core::rra6502, &cpu_6502_core::absx6502    },   // 0x7F (UNDOC)
+	{ &cpu_6502_core::bra6502, &cpu_6502_core::relative6502 },  // 0x80 (CMOS)
+	{ &cpu_6502_core::sta6502, &cpu_6502_core::indx6502 },	  // 0x81
+	{ &cpu_6502_core::nop6502, &cpu_6502_core::implied6502 },   // 0x82
+	{ &cpu_6502_core::sax6502, &cpu_6502_core::indx6502 },      // 0x83 SAX (ind,X) (UNDOC)
+	{ &cpu_6502_core::sty6502, &cpu_6502_core::zp6502 },		  // 0x84
+	{ &cpu_6502_core::sta6502, &cpu_6502_core::zp6502 },		  // 0x85
+	{ &cpu_6502_core::stx6502, &cpu_6502_core::zp6502 },		  // 0x86
+	{ &cpu_6502_core::sax6502, &cpu_6502_core::zp6502 },		  // 0x87 SAX zp (UNDOC)
+	{ &cpu_6502_core::dey6502, &cpu_6502_core::implied6502 },   // 0x88
+	{ &cpu_6502_core::bit6502, &cpu_6502_core::immediate6502 }, // 0x89 (CMOS uses this, NMOS UNDOC)
+	{ &cpu_6502_core::txa6502, &cpu_6502_core::implied6502 },   // 0x8A
+	{ &cpu_6502_core::ane6502, &cpu_6502_core::immediate6502 }, // 0x8B ANE/XAA (UNDOC)
+	{ &cpu_6502_core::sty6502, &cpu_6502_core::abs6502 },       // 0x8C
+	{ &cpu_6502_core::sta6502, &cpu_6502_core::abs6502 },       // 0x8D
+	{ &cpu_6502_core::stx6502, &cpu_6502_core::abs6502 },       // 0x8E
+	{ &cpu_6502_core::sax6502, &cpu_6502_core::abs6502 },       // 0x8F SAX abs (UNDOC)
+	{ &cpu_6502_core::bcc6502, &cpu_6502_core::relative6502 },  // 0x90
+	{ &cpu_6502_core::sta6502, &cpu_6502_core::indy6502 },      // 0x91
+	{ &cpu_6502_core::sta6502, &cpu_6502_core::indzp6502 },	  // 0x92 (CMOS)
+	{ &cpu_6502_core::ahx6502, &cpu_6502_core::indy6502 },      // 0x93 AHX (ind),Y (UNDOC)
+	{ &cpu_6502_core::sty6502, &cpu_6502_core::zpx6502 },		  // 0x94
+	{ &cpu_6502_core::sta6502, &cpu_6502_core::zpx6502 },		  // 0x95
+	{ &cpu_6502_core::stx6502, &cpu_6502_core::zpy6502 },		  // 0x96
+	{ &cpu_6502_core::sax6502, &cpu_6502_core::zpy6502 },       // 0x97 SAX zp,Y (UNDOC)
+	{ &cpu_6502_core::tya6502, &cpu_6502_core::implied6502 },   // 0x98
+	{ &cpu_6502_core::sta6502, &cpu_6502_core::absy6502 },	  // 0x99
+	{ &cpu_6502_core::txs6502, &cpu_6502_core::implied6502 },   // 0x9A
+	{ &cpu_6502_core::shs6502, &cpu_6502_core::absy6502 },      // 0x9B SHS/TAS abs,Y (UNDOC)
+	{ &cpu_6502_core::stz6502, &cpu_6502_core::abs6502 },		  // 0x9C (CMOS)
+	{ &cpu_6502_core::sta6502, &cpu_6502_core::absx6502 },	  // 0x9D
+	{ &cpu_6502_core::stz6502, &cpu_6502_core::absx6502 },	  // 0x9E (CMOS)
+	{ &cpu_6502_core::ahx6502, &cpu_6502_core::absy6502 },      // 0x9F AHX abs,Y (UNDOC)
+	{ &cpu_6502_core::ldy6502, &cpu_6502_core::immediate6502 }, // 0xA0
+	{ &cpu_6502_core::lda6502, &cpu_6502_core::indx6502 },      // 0xA1
+	{ &cpu_6502_core::ldx6502, &cpu_6502_core::immediate6502 }, // 0xA2
+	{ &cpu_6502_core::lax6502, &cpu_6502_core::indx6502 },      // 0xA3 (UNDOC)
+	{ &cpu_6502_core::ldy6502, &cpu_6502_core::zp6502 },        // 0xA4
+	{ &cpu_6502_core::lda6502, &cpu_6502_core::zp6502 },        // 0xA5
+	{ &cpu_6502_core::ldx6502, &cpu_6502_core::zp6502 },        // 0xA6
+	{ &cpu_6502_core::lax6502, &cpu_6502_core::zp6502 },        // 0xA7 (UNDOC)
+	{ &cpu_6502_core::tay6502, &cpu_6502_core::implied6502 },   // 0xA8
+	{ &cpu_6502_core::lda6502, &cpu_6502_core::immediate6502 }, // 0xA9
+	{ &cpu_6502_core::tax6502, &cpu_6502_core::implied6502 },   // 0xAA
+	{ &cpu_6502_core::lxa6502, &cpu_6502_core::immediate6502 }, // 0xAB LXA/ATX imm (UNDOC)
+	{ &cpu_6502_core::ldy6502, &cpu_6502_core::abs6502 },       // 0xAC
+	{ &cpu_6502_core::lda6502, &cpu_6502_core::abs6502 },       // 0xAD
+	{ &cpu_6502_core::ldx6502, &cpu_6502_core::abs6502 },       // 0xAE
+	{ &cpu_6502_core::lax6502, &cpu_6502_core::abs6502 },       // 0xAF (UNDOC)
+	{ &cpu_6502_core::bcs6502, &cpu_6502_core::relative6502 },  // 0xB0
+	{ &cpu_6502_core::lda6502, &cpu_6502_core::indy6502 },      // 0xB1
+	{ &cpu_6502_core::nop6502, &cpu_6502_core::implied6502 },   // 0xB2 (CMOS Ind ZP uses this slot usually)
+	{ &cpu_6502_core::lax6502, &cpu_6502_core::indy6502 },      // 0xB3 (UNDOC)
+	{ &cpu_6502_core::ldy6502, &cpu_6502_core::zpx6502 },       // 0xB4
+	{ &cpu_6502_core::lda6502, &cpu_6502_core::zpx6502 },       // 0xB5
+	{ &cpu_6502_core::ldx6502, &cpu_6502_core::zpy6502 },       // 0xB6
+	{ &cpu_6502_core::lax6502, &cpu_6502_core::zpy6502 },       // 0xB7 (UNDOC)
+	{ &cpu_6502_core::clv6502, &cpu_6502_core::implied6502 },   // 0xB8
+	{ &cpu_6502_core::lda6502, &cpu_6502_core::absy6502 },      // 0xB9
+	{ &cpu_6502_core::tsx6502, &cpu_6502_core::implied6502 },   // 0xBA
+	{ &cpu_6502_core::las6502, &cpu_6502_core::absy6502 },      // 0xBB LAS abs,Y (UNDOC)
+	{ &cpu_6502_core::ldy6502, &cpu_6502_core::absx6502 },      // 0xBC
+	{ &cpu_6502_core::lda6502, &cpu_6502_core::absx6502 },      // 0xBD
+	{ &cpu_6502_core::ldx6502, &cpu_6502_core::absy6502 },      // 0xBE
+	{ &cpu_6502_core::lax6502, &cpu_6502_core::absy6502 },      // 0xBF (UNDOC)
+	{ &cpu_6502_core::cpy6502, &cpu_6502_core::immediate6502 }, // 0xC0
+	{ &cpu_6502_core::cmp6502, &cpu_6502_core::indx6502 },      // 0xC1
+	{ &cpu_6502_core::nop6502, &cpu_6502_core::implied6502 },   // 0xC2
+	{ &cpu_6502_core::dcp6502, &cpu_6502_core::indx6502 },      // 0xC3 (UNDOC)
+	{ &cpu_6502_core::cpy6502, &cpu_6502_core::zp6502 },        // 0xC4
+	{ &cpu_6502_core::cmp6502, &cpu_6502_core::zp6502 },        // 0xC5
+	{ &cpu_6502_core::dec6502, &cpu_6502_core::zp6502 },        // 0xC6
+	{ &cpu_6502_core::dcp6502, &cpu_6502_core::zp6502 },        // 0xC7 (UNDOC)
+	{ &cpu_6502_core::iny6502, &cpu_6502_core::implied6502 },   // 0xC8
+	{ &cpu_6502_core::cmp6502, &cpu_6502_core::immediate6502 }, // 0xC9
+	{ &cpu_6502_core::dex6502, &cpu_6502_core::implied6502 },   // 0xCA
+	{ &cpu_6502_core::axs6502, &cpu_6502_core::immediate6502 }, // 0xCB AXS/SBX imm (UNDOC)
+	{ &cpu_6502_core::cpy6502, &cpu_6502_core::abs6502 },		  // 0xCC
+	{ &cpu_6502_core::cmp6502, &cpu_6502_core::abs6502 },		  // 0xCD
+	{ &cpu_6502_core::dec6502, &cpu_6502_core::abs6502 },		  // 0xCE
+	{ &cpu_6502_core::dcp6502, &cpu_6502_core::abs6502 },		  // 0xCF (UNDOC)
+	{ &cpu_6502_core::bne6502, &cpu_6502_core::relative6502 },  // 0xD0
+	{ &cpu_6502_core::cmp6502, &cpu_6502_core::indy6502 },	  // 0xD1
+	{ &cpu_6502_core::cmp6502, &cpu_6502_core::indzp6502 },	  // 0xD2 (CMOS)
+	{ &cpu_6502_core::dcp6502, &cpu_6502_core::indy6502 },      // 0xD3 DCP (ind),Y (UNDOC)
+	{ &cpu_6502_core::nop6502, &cpu_6502_core::implied6502 },   // 0xD4
+	{ &cpu_6502_core::cmp6502, &cpu_6502_core::zpx6502 },		  // 0xD5
+	{ &cpu_6502_core::dec6502, &cpu_6502_core::zpx6502 },		  // 0xD6
+	{ &cpu_6502_core::dcp6502, &cpu_6502_core::zpx6502 },		  // 0xD7 (UNDOC)
+	{ &cpu_6502_core::cld6502, &cpu_6502_core::implied6502 },   // 0xD8
+	{ &cpu_6502_core::cmp6502, &cpu_6502_core::absy6502 },	  // 0xD9
+	{ &cpu_6502_core::phx6502, &cpu_6502_core::implied6502 },	  // 0xDA (CMOS)
+	{ &cpu_6502_core::dcp6502, &cpu_6502_core::absy6502 },	  // 0xDB (UNDOC)
+	{ &cpu_6502_core::nop6502, &cpu_6502_core::implied6502 },   // 0xDC
+	{ &cpu_6502_core::cmp6502, &cpu_6502_core::absx6502 },	  // 0xDD
+	{ &cpu_6502_core::dec6502, &cpu_6502_core::absx6502 },	  // 0xDE
+	{ &cpu_6502_core::dcp6502, &cpu_6502_core::absx6502 },	  // 0xDF (UNDOC)
+	{ &cpu_6502_core::cpx6502, &cpu_6502_core::immediate6502 }, // 0xE0
+	{ &cpu_6502_core::sbc6502, &cpu_6502_core::indx6502 },	  // 0xE1
+	{ &cpu_6502_core::nop6502, &cpu_6502_core::implied6502 },   // 0xE2
+	{ &cpu_6502_core::isc6502, &cpu_6502_core::indx6502 },	  // 0xE3 (UNDOC)
+	{ &cpu_6502_core::cpx6502, &cpu_6502_core::zp6502 },		  // 0xE4
+	{ &cpu_6502_core::sbc6502, &cpu_6502_core::zp6502 },		  // 0xE5
+	{ &cpu_6502_core::inc6502, &cpu_6502_core::zp6502 },		  // 0xE6
+	{ &cpu_6502_core::isc6502, &cpu_6502_core::zp6502 },		  // 0xE7 (UNDOC)
+	{ &cpu_6502_core::inx6502, &cpu_6502_core::implied6502 },   // 0xE8
+	{ &cpu_6502_core::sbc6502, &cpu_6502_core::immediate6502 }, // 0xE9
+	{ &cpu_6502_core::nop6502, &cpu_6502_core::implied6502 },   // 0xEA
+	{ &cpu_6502_core::nop6502, &cpu_6502_core::implied6502 },   // 0xEB
+	{ &cpu_6502_core::cpx6502, &cpu_6502_core::abs6502 },		  // 0xEC
+	{ &cpu_6502_core::sbc6502, &cpu_6502_core::abs6502 },		  // 0xED
+	{ &cpu_6502_core::inc6502, &cpu_6502_core::abs6502 },		  // 0xEE
+	{ &cpu_6502_core::isc6502, &cpu_6502_core::abs6502 },		  // 0xEF (UNDOC)
+	{ &cpu_6502_core::beq6502, &cpu_6502_core::relative6502 },  // 0xF0
+	{ &cpu_6502_core::sbc6502, &cpu_6502_core::indy6502 },	  // 0xF1
+	{ &cpu_6502_core::sbc6502, &cpu_6502_core::indzp6502 },	  // 0xF2 (CMOS)
+	{ &cpu_6502_core::isc6502, &cpu_6502_core::indy6502 },      // 0xF3 ISC (ind),Y (UNDOC)
+	{ &cpu_6502_core::nop6502, &cpu_6502_core::implied6502 },   // 0xF4
+	{ &cpu_6502_core::sbc6502, &cpu_6502_core::zpx6502 },		  // 0xF5
+	{ &cpu_6502_core::inc6502, &cpu_6502_core::zpx6502 },       // 0xF6
+	{ &cpu_6502_core::isc6502, &cpu_6502_core::zpx6502 },		  // 0xF7 (UNDOC)
+	{ &cpu_6502_core::sed6502, &cpu_6502_core::implied6502 },   // 0xF8
+	{ &cpu_6502_core::sbc6502, &cpu_6502_core::absy6502 },      // 0xF9
+	{ &cpu_6502_core::plx6502, &cpu_6502_core::implied6502 },   // 0xFA (CMOS)
+	{ &cpu_6502_core::isc6502, &cpu_6502_core::absy6502 },      // 0xFB (UNDOC)
+	{ &cpu_6502_core::nop6502, &cpu_6502_core::absx6502 },      // 0xFC
+	{ &cpu_6502_core::sbc6502, &cpu_6502_core::absx6502 },      // 0xFD
+	{ &cpu_6502_core::inc6502, &cpu_6502_core::absx6502 },      // 0xFE
+	{ &cpu_6502_core::isc6502, &cpu_6502_core::absx6502 }       // 0xFF (UNDOC)
+};
+
+// -----------------------------------------------------------------------------
+// Name: init6502
+// Purpose: Initializes the 6502 CPU instance and selects the opcode table for
+//          an NMOS 6502, CMOS 65C02, NES or 6510.
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::init6502(uint16_t addrmaskval, CpuModel model)
+{
+	PC = PPC = 0;
+	addrmask = addrmaskval;
+	_irqPending = 0;
+	_irqMode = 0;
+	clocktickstotal = 0;
+	cpu_model = model;
+
+	const ModelTables& tables = model_tables(model);
+	opcode_table = tables.ops;
+	fused_first = tables.fused_first;
+
+	rebuild_memory_map();
+}
+
+// -----------------------------------------------------------------------------
+// Opcode and fused pair tables for all four models, built on first use.
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+const typename cpu_6502_core<Hooks, Bus>::ModelTables& cpu_6502_core<Hooks, Bus>::model_tables(CpuModel model)
+{
+	struct AllModels
+	{
+		ModelTables models[4];
+
+		AllModels()
+		{
+			for (int m = 0; m < 4; m++)
+			{
+				build_opcode_table((CpuModel)m, models[m].ops);
+				build_fused_table(models[m]);
+			}
+		}
+	};
+
+	static const AllModels all;
+	return all.models[model];
+}
+
+// -----------------------------------------------------------------------------
+// Name: build_opcode_table
+// Purpose: Patches a copy of the master table based on whether we are emulating
+//          an NMOS 6502, CMOS 65C02, or NES.
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::build_opcode_table(CpuModel model, OpEntry* opcode_table)
+{
+	// 1. Copy the master table (Contains ALL variants)
+	memcpy(opcode_table, initial_opcode_table, sizeof(initial_opcode_table));
+
+	// 2. Prune the table based on architecture type.
+
+	// Case A: CMOS 65C02
+	if (model == CPU_CMOS_65C02)
+	{
+		// 1. Map CMOS-Specific ALU functions (Decimal Flag fixes)
+		static const uint8_t adc_ops[] = { 0x61, 0x65, 0x69, 0x6D, 0x71, 0x72, 0x75, 0x79, 0x7D };
+		static const uint8_t sbc_ops[] = { 0xE1, 0xE5, 0xE9, 0xED, 0xF1, 0xF2, 0xF5, 0xF9, 0xFD };
+
+		for (uint8_t op : adc_ops) opcode_table[op].instruction = &cpu_6502_core::adc65c02;
+		for (uint8_t op : sbc_ops) opcode_table[op].instruction = &cpu_6502_core::sbc65c02;
+
+		// 2. NOP out Undocumented NMOS Instructions (CMOS doesn't support them)
+		//    We keep the addressing mode (implied behavior for multi-byte NOPs)
+		static const uint8_t nmos_undoc_opcodes[] = {
+			0xA3, 0xA7, 0xAB, 0xAF, 0xB3, 0xB7, 0xBF, // LAX
+			0x83, 0x87, 0x8F, 0x97,                   // SAX
+			0x03, 0x07, 0x0F, 0x13, 0x17, 0x1B, 0x1F, // SLO
+			0x23, 0x27, 0x2F, 0x33, 0x37, 0x3B, 0x3F, // RLA
+			0x43, 0x47, 0x4F, 0x53, 0x57, 0x5B, 0x5F, // SRE
+			0x63, 0x67, 0x6F, 0x73, 0x77, 0x7B, 0x7F, // RRA
+			0xC3, 0xC7, 0xCF, 0xD3, 0xD7, 0xDB, 0xDF, // DCP
+			0xE3, 0xE7, 0xEF, 0xF3, 0xF7, 0xFB, 0xFF, // ISC
+			0x0B, 0x2B, 0x4B, 0x6B, 0x8B, 0x9B, 0xBB, 0xCB // Other
+		};
+
+		for (uint8_t op : nmos_undoc_opcodes)
+		{
+			opcode_table[op].instruction = &cpu_6502_core::nop6502;
+			opcode_table[op].addressing_mode = &cpu_6502_core::implied6502;
+		}
+
+		// Map Rockwell/WDC Bit Manipulation Instructions
+		// RMB0-7, SMB0-7, BBR0-7, BBS0-7
+		for (int i = 0; i < 8; i++)
+		{
+			// RMBx (Opcode 07, 17 ... 77)
+			int rmb_op = (i << 4) | 0x07;
+			opcode_table[rmb_op].instruction = &cpu_6502_core::rmb_smb_6502;
+			opcode_table[rmb_op].addressing_mode = &cpu_6502_core::zp6502;
+
+			// SMBx (Opcode 87, 97 ... F7)
+			int smb_op = (i << 4) | 0x87;
+			opcode_table[smb_op].instruction = &cpu_6502_core::rmb_smb_6502;
+			opcode_table[smb_op].addressing_mode = &cpu_6502_core::zp6502;
+
+			// BBRx (Opcode 0F, 1F ... 7F)
+			int bbr_op = (i << 4) | 0x0F;
+			opcode_table[bbr_op].instruction = &cpu_6502_core::bbr_bbs_6502;
+			opcode_table[bbr_op].addressing_mode = &cpu_6502_core::zprel6502;
+
+			// BBSx (Opcode 8F, 9F ... FF)
+			int bbs_op = (i << 4) | 0x8F;
+			opcode_table[bbs_op].instruction = &cpu_6502_core::bbr_bbs_6502;
+			opcode_table[bbs_op].addressing_mode = &cpu_6502_core::zprel6502;
+		}
+		// 1. Map 2-byte NOPs (Immediate Addressing)
+		// These are opcodes: 02, 22, 42, 62, 82, C2, E2
+		static const uint8_t nop_2byte[] = {0x02, 0x22, 0x42, 0x62, 0x82, 0xC2, 0xE2,	0x44, 0x54, 0xD4, 0xF4 };
+		for (uint8_t op : nop_2byte) {
+			opcode_table[op].instruction = &cpu_6502_core::nop6502;
+			opcode_table[op].addressing_mode = &cpu_6502_core::immediate6502; // Consumes 2 bytes (Op + Imm)
+		}
+
+		// 2. Map 3-byte NOPs (Absolute/AbsX Addressing)
+		// 5C = NOP Abs (3 bytes, 4 cycles)
+		opcode_table[0x5C].instruction = &cpu_6502_core::nop6502;
+		opcode_table[0x5C].addressing_mode = &cpu_6502_core::abs6502;
+
+		// DC = NOP Abs,X (3 bytes, 4 cycles)
+		opcode_table[0xDC].instruction = &cpu_6502_core::nop6502;
+		opcode_table[0xDC].addressing_mode = &cpu_6502_core::absx6502;
+
+		// FC is usually already mapped to NOP+AbsX in your initial table, but safe to enforce:
+		opcode_table[0xFC].instruction = &cpu_6502_core::nop6502;
+		opcode_table[0xFC].addressing_mode = &cpu_6502_core::absx6502;
+
+		// FIX: Map CMOS Zero Page Indirect instructions ($zp)
+		// Opcodes: 12, 32, 52, 72, 92, B2, D2, F2
+		// -----------------------------------------------------------
+		opcode_table[0x12].instruction = &cpu_6502_core::ora6502; opcode_table[0x12].addressing_mode = &cpu_6502_core::indzp6502;
+		opcode_table[0x32].instruction = &cpu_6502_core::and6502; opcode_table[0x32].addressing_mode = &cpu_6502_core::indzp6502;
+		opcode_table[0x52].instruction = &cpu_6502_core::eor6502; opcode_table[0x52].addressing_mode = &cpu_6502_core::indzp6502;
+		opcode_table[0x72].instruction = &cpu_6502_core::adc65c02; opcode_table[0x72].addressing_mode = &cpu_6502_core::indzp6502;
+		opcode_table[0x92].instruction = &cpu_6502_core::sta6502; opcode_table[0x92].addressing_mode = &cpu_6502_core::indzp6502;
+		opcode_table[0xB2].instruction = &cpu_6502_core::lda6502; opcode_table[0xB2].addressing_mode = &cpu_6502_core::indzp6502;
+		opcode_table[0xD2].instruction = &cpu_6502_core::cmp6502; opcode_table[0xD2].addressing_mode = &cpu_6502_core::indzp6502;
+		opcode_table[0xF2].instruction = &cpu_6502_core::sbc65c02; opcode_table[0xF2].addressing_mode = &cpu_6502_core::indzp6502;
+	}
+	// Case B: NMOS 6502 or NES 2A03
+	else
+	{
+		// 1. Map 1-byte CMOS NOPs (Implied)
+		// INC/DEC A (1A, 3A), PHY/PLY (5A, 7A), PHX/PLX (DA, FA)
+		static const uint8_t nops_1byte[] = {
+			0x1A, 0x3A, 0x5A, 0x7A, 0xDA, 0xFA
+		};
+
+		for (uint8_t op : nops_1byte)
+		{
+			opcode_table[op].instruction = &cpu_6502_core::nop6502;
+			opcode_table[op].addressing_mode = &cpu_6502_core::implied6502;
+		}
+
+		// 2. Map 2-byte CMOS NOPs (Zero Page / Imm / Relative)
+		// 0x04 (TSB), 0x14 (TRB), 0x34 (BIT ZPX), 0x44, 0x54, 0x64 (STZ), 0x74 (STZ), 0xD4, 0xF4
+		// 0x80 (BRA), 0x89 (BIT Imm)
+		// 0x12, 0x32... (Ind ZP) - usually JAM on NMOS, but if NOP'd, must be 2 bytes
+		static const uint8_t nops_2byte[] = {
+			0x04, 0x14, 0x34, 0x44, 0x54, 0x64, 0x74, 0xD4, 0xF4,
+			0x80, 0x89,
+			0x12, 0x32, 0x52, 0x72, 0x92, 0xB2, 0xD2, 0xF2
+		};
+
+		for (uint8_t op : nops_2byte)
+		{
+			opcode_table[op].instruction = &cpu_6502_core::nop6502;
+			// Use zp6502 to consume the operand byte (PC+2 total)
+			opcode_table[op].addressing_mode = &cpu_6502_core::zp6502;
+		}
+
+		// 3. Map 3-byte CMOS NOPs (Absolute / AbsX)
+		// 0x0C (TSB Abs), 0x1C (TRB Abs), 0x3C (BIT AbsX), 0x7C (JMP Ind,X)
+		static const uint8_t nops_3byte[] = {
+			0x0C, 0x1C, 0x3C, 0x5C, 0x7C, 0xDC, 0xFC
+		};
+
+		for (uint8_t op : nops_3byte)
+		{
+			opcode_table[op].instruction = &cpu_6502_core::nop6502;
+			// Use abs6502 to consume 2 operand bytes (PC+3 total)
+			opcode_table[op].addressing_mode = &cpu_6502_core::abs6502;
+		}
+		opcode_table[0xEB].instruction = &cpu_6502_core::sbc6502;
+		opcode_table[0xEB].addressing_mode = &cpu_6502_core::immediate6502;
+		// 4. Handle NMOS Specific Undocumented Overwrites
+		// NMOS 0x9C is SHY (Abs,X) - not STZ
+		opcode_table[0x9C].instruction = &cpu_6502_core::shy6502;
+		opcode_table[0x9C].addressing_mode = &cpu_6502_core::absx6502;
+
+		// NMOS 0x9E is SHX (Abs,Y) - not STZ
+		opcode_table[0x9E].instruction = &cpu_6502_core::shx6502;
+		opcode_table[0x9E].addressing_mode = &cpu_6502_core::absy6502;
+	}
+
+	// 3. Apply NES 2A03 Specific Patches (BCD Disable)
+	if (model == CPU_NES_2A03)
+	{
+		static const uint8_t adc_ops[] = { 0x61, 0x65, 0x69, 0x6D, 0x71, 0x72, 0x75, 0x79, 0x7D };
+		static const uint8_t sbc_ops[] = { 0xE1, 0xE5, 0xE9, 0xED, 0xF1, 0xF2, 0xF5, 0xF9, 0xFD };
+		static const uint8_t rra_ops[] = { 0x63, 0x67, 0x6F, 0x73, 0x77, 0x7B, 0x7F };
+		static const uint8_t isc_ops[] = { 0xE3, 0xE7, 0xEF, 0xF3, 0xF7, 0xFB, 0xFF };
+
+		for (uint8_t op : adc_ops) opcode_table[op].instruction = &cpu_6502_core::adc_2a03;
+		for (uint8_t op : sbc_ops) opcode_table[op].instruction = &cpu_6502_core::sbc_2a03;
+		for (uint8_t op : rra_ops) opcode_table[op].instruction = &cpu_6502_core::rra_2a03;
+		for (uint8_t op : isc_ops) opcode_table[op].instruction = &cpu_6502_core::isc_2a03;
+	}
+}
+
+// -----------------------------------------------------------------------------
+// 6502 CPU Constructor.
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+cpu_6502_core<Hooks, Bus>::cpu_6502_core(uint8_t* mem, MemoryReadByte* read_mem, MemoryWriteByte* write_mem, uint16_t addr, int num, CpuModel model)
+{
+	MEM = mem;
+	memory_write = write_mem;
+	memory_read = read_mem;
+	cpu_num = num;
+	log_debug_rw = 1;
+	mmem = false;
+	debug = 0;
+
+	// Pass the model through to the initialization logic
+	init6502(addr, model);
+}
+
+// -----------------------------------------------------------------------------
+// Get the Total Number of Clock Ticks Executed.
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+int cpu_6502_core<Hooks, Bus>::get6502ticks(int reset)
+{
+	int tmp = clocktickstotal;
+	if (reset)
+		clocktickstotal = 0;
+	return tmp;
+}
+
+// -----------------------------------------------------------------------------
+// Get a copy of the performance counters, optionally zeroing them. The cycles
+// zeroed move to cycle_base, so get_cycles() keeps counting.
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+cpu6502_counters cpu_6502_core<Hooks, Bus>::get_counters(bool reset)
+{
+	cpu6502_counters tmp = counters;
+	if (reset)
+	{
+		cycle_base += counters.cycles;
+		counters = cpu6502_counters();
+	}
+	return tmp;
+}
+
+// -----------------------------------------------------------------------------
+// get6502memory / put6502memory
+// Every CPU data access goes through these, so this is where on_read/on_write
+// fire. Debugger and disassembler reads use peek and stay invisible.
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+uint8_t cpu_6502_core<Hooks, Bus>::get6502memory(uint16_t addr)
+{
+	const uint8_t data = bus_read(addr);
+	hooks.on_read(*this, addr & addrmask, data);
+	return data;
+}
+
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::put6502memory(uint16_t addr, uint8_t byte)
+{
+	hooks.on_write(*this, addr & addrmask, byte);
+	bus_write(addr, byte);
+}
+
+// -----------------------------------------------------------------------------
+// bus_read
+// Mapped pages are read directly, everything else goes through read_slow.
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+uint8_t cpu_6502_core<Hooks, Bus>::bus_read(uint16_t addr)
+{
+	addr &= addrmask;
+
+	const uint8_t* page = map->read[addr >> 8];
+	if (page)
+	{
+		counters.direct_accesses++;
+		return page[addr & 0xFF];
+	}
+
+	return read_slow(addr);
+}
+
+// -----------------------------------------------------------------------------
+// Code fetch
+// Instruction bytes come from the page PC is on. Its map entry is looked up
+// once when PC moves to another page (sequential flow, a branch or a jump),
+// then every opcode and operand byte on the page is a direct load. Unmapped
+// and watched pages have a null entry and take bus_read's slow path.
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+inline uint8_t cpu_6502_core<Hooks, Bus>::code_read(uint16_t addr)
+{
+	addr &= addrmask;
+
+	if ((addr >> 8) != code_page_index)
+	{
+		code_page_index = addr >> 8;
+		code_page = map->read[code_page_index];
+	}
+
+	if (code_page)
+	{
+		counters.direct_accesses++;
+		return code_page[addr & 0xFF];
+	}
+
+	return read_slow(addr);
+}
+
+template <class Hooks, class Bus>
+inline uint8_t cpu_6502_core<Hooks, Bus>::fetch8()
+{
+	const uint16_t pc = PC++;
+	const uint8_t data = code_read(pc);
+	hooks.on_read(*this, pc & addrmask, data);
+	return data;
+}
+
+template <class Hooks, class Bus>
+inline uint16_t cpu_6502_core<Hooks, Bus>::fetch16()
+{
+	const uint8_t lo = code_read(PC);
+	hooks.on_read(*this, PC & addrmask, lo);
+	const uint8_t hi = code_read(PC + 1);
+	hooks.on_read(*this, (PC + 1) & addrmask, hi);
+	return lo | (hi << 8);
+}
+
+// -----------------------------------------------------------------------------
+// rmw_read / rmw_write
+// The write pointer is only taken when the read was direct. A handler read may
+// switch banks, so after one the write resolves the address again.
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+inline typename cpu_6502_core<Hooks, Bus>::RmwAccess cpu_6502_core<Hooks, Bus>::rmw_read()
+{
+	const uint16_t addr = savepc & addrmask;
+	const uint8_t* page = map->read[addr >> 8];
+	RmwAccess m;
+
+	if (page)
+	{
+		counters.direct_accesses++;
+		m.data = page[addr & 0xFF];
+		m.direct = map->write[addr >> 8];
+		if (m.direct)
+			m.direct += addr & 0xFF;
+	}
+	else
+	{
+		m.data = read_slow(addr);
+		m.direct = nullptr;
+	}
+
+	hooks.on_read(*this, addr, m.data);
+	return m;
+}
+
+template <class Hooks, class Bus>
+inline void cpu_6502_core<Hooks, Bus>::rmw_write(const RmwAccess& m, uint8_t byte)
+{
+	if (rmw_dummy_write && cpu_model != CPU_CMOS_65C02)
+	{
+		put6502memory(savepc, m.data);
+		put6502memory(savepc, byte);
+		return;
+	}
+
+	if (m.direct)
+	{
+		hooks.on_write(*this, savepc & addrmask, byte);
+		counters.direct_accesses++;
+		*m.direct = byte;
+		return;
+	}
+
+	put6502memory(savepc, byte);
+}
+
+// -----------------------------------------------------------------------------
+// read_slow
+// 6510 port, handler search, then the flat image. Also where read watchpoints fire.
+// A mapped page only gets here while it is watched, and reads its map entry, so
+// a page moved by map_memory is read from its bank and not from the handlers.
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+uint8_t cpu_6502_core<Hooks, Bus>::read_slow(uint16_t addr)
+{
+	uint8_t data = 0;
+
+	if (cpu_model == CPU_6510 && addr < 2)
+	{
+		if (addr == 0) data = ddr;
+		else
+		{
+			// Accurate Logic:
+			// If Bit is Output (1): Return the Latch value (port_out)
+			// If Bit is Input (0):  Return the Pin value (port_in)
+			data = (port_out & ddr) | (port_in & ~ddr);
+		}
+	}
+	else if (const uint8_t* page = base->read[addr >> 8])
+	{
+		counters.direct_accesses++;
+		data = page[addr & 0xFF];
+	}
+	else if constexpr (Bus::fixed)
+	{
+		const int i = Bus::find(addr);
+		const cpu6502_bus_kind kind = i < 0 ? BUS_NONE : Bus::ranges[i].read;
+
+		if (kind == BUS_IO)
+		{
+			counters.handler_calls++;
+			data = bus.io_read(Bus::ranges[i].device, (uint16_t)(addr - Bus::ranges[i].lo));
+		}
+		else if (kind == BUS_MEM)
+		{
+			counters.direct_accesses++;
+			data = MEM[addr];
+		}
+		else
+		{
+			counters.unhandled++;
+			if (log_debug_rw)
+				LOG_INFO_RL("Warning! Unhandled Read at %x", addr);
+		}
+	}
+	else
+	{
+		MemoryReadByte* reader = memory_read;
+		while (reader->lowAddr != (unsigned)-1)
+		{
+			if (addr >= reader->lowAddr && addr <= reader->highAddr)
+				break;
+			++reader;
+		}
+
+		if (reader->lowAddr != (unsigned)-1)
+		{
+			hooks.on_handler_read(*this, reader, addr);
+			if (reader->memoryCall)
+			{
+				counters.handler_calls++;
+				data = reader->memoryCall(addr - reader->lowAddr, reader);
+			}
+			else
+			{
+				counters.direct_accesses++;
+				data = ((const uint8_t*)reader->pUserArea)[addr - reader->lowAddr];
+			}
+			hooks.on_handler_read_done(*this, reader);
+		}
+		else if (!mmem)
+		{
+			counters.direct_accesses++;
+			data = MEM[addr];
+		}
+		else
+		{
+			counters.unhandled++;
+			if (log_debug_rw)
+				LOG_INFO_RL("Warning! Unhandled Read at %x", addr);
+		}
+	}
+
+	if (dbg && (dbg->trap_flags[addr >> 8] & TRAP_READ))
+		check_watchpoints(addr, data, TRAP_READ);
+
+	return data;
+}
+
+// -----------------------------------------------------------------------------
+// bus_write
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::bus_write(uint16_t addr, uint8_t byte)
+{
+	addr &= addrmask;
+
+	uint8_t* page = map->write[addr >> 8];
+	if (page)
+	{
+		counters.direct_accesses++;
+		page[addr & 0xFF] = byte;
+		return;
+	}
+
+	write_slow(addr, byte);
+}
+
+// -----------------------------------------------------------------------------
+// write_slow
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::write_slow(uint16_t addr, uint8_t byte)
+{
+	if (dbg && (dbg->trap_flags[addr >> 8] & TRAP_WRITE))
+		check_watchpoints(addr, byte, TRAP_WRITE);
+
+	if (cpu_model == CPU_6510 && addr < 2)
+	{
+		uint8_t old_ddr = ddr;
+		uint8_t old_port = port_out;
+
+		if (addr == 0) ddr = byte;
+		if (addr == 1) port_out = byte;
+
+		check_and_notify_6510(old_ddr, old_port);
+		select_6510_map();
+		return;
+	}
+
+	if (uint8_t* page = base->write[addr >> 8])
+	{
+		counters.direct_accesses++;
+		page[addr & 0xFF] = byte;
+		return;
+	}
+
+	if constexpr (Bus::fixed)
+	{
+		const int i = Bus::find(addr);
+		const cpu6502_bus_kind kind = i < 0 ? BUS_NONE : Bus::ranges[i].write;
+
+		if (kind == BUS_IO)
+		{
+			counters.handler_calls++;
+			bus.io_write(Bus::ranges[i].device, (uint16_t)(addr - Bus::ranges[i].lo), byte);
+			return;
+		}
+		if (kind == BUS_MEM)
+		{
+			counters.direct_accesses++;
+			MEM[addr] = byte;
+			return;
+		}
+		// Unmapped, or a write to ROM. Dropped.
+		if (i < 0)
+		{
+			counters.unhandled++;
+			if (log_debug_rw)
+				LOG_INFO_RL("Warning! Unhandled Write %02X at %x", byte, addr);
+		}
+		return;
+	}
+
+	MemoryWriteByte* writer = memory_write;
+	while (writer->lowAddr != (unsigned)-1)
+	{
+		if (addr >= writer->lowAddr && addr <= writer->highAddr)
+		{
+			hooks.on_handler_write(*this, writer, addr);
+			if (writer->memoryCall)
+			{
+				counters.handler_calls++;
+				writer->memoryCall(addr - writer->lowAddr, byte, writer);
+			}
+			else
+			{
+				counters.direct_accesses++;
+				((uint8_t*)writer->pUserArea)[addr - writer->lowAddr] = byte;
+			}
+			hooks.on_handler_write_done(*this, writer);
+			return;
+		}
+		++writer;
+	}
+
+	if (!mmem) {
+		counters.direct_accesses++;
+		MEM[addr] = byte; return;
+	}
+
+	counters.unhandled++;
+	if (log_debug_rw)
+		LOG_INFO_RL("Warning! Unhandled Write %02X at %x", byte, addr);
+}
+
+// -----------------------------------------------------------------------------
+// rebuild_memory_map
+// A page gets a direct pointer only when every address in it resolves the same
+// way the handler search would: either the first handler touching the page
+// covers all of it with a plain pUserArea buffer, or no handler touches it and
+// unhandled accesses fall through to MEM. With a fixed bus, a page is mapped
+// when a single RAM or ROM range covers it.
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::rebuild_memory_map()
+{
+	base_map = {};
+
+	// The map is indexed by the masked address, so the mask must keep whole pages.
+	if ((addrmask & 0xFF) != 0xFF)
+	{
+		update_traps();
+		return;
+	}
+
+	if constexpr (Bus::fixed)
+	{
+		for (unsigned int page = 0; page < 256 && MEM; page++)
+		{
+			if (cpu_model == CPU_6510 && page == 0)
+				continue;
+
+			const int i = Bus::page_range(page);
+			if (i >= 0 && Bus::ranges[i].read == BUS_MEM)
+				base_map.read[page] = MEM + (page << 8);
+			if (i >= 0 && Bus::ranges[i].write == BUS_MEM)
+				base_map.write[page] = MEM + (page << 8);
+		}
+
+		update_traps();
+		return;
+	}
+
+	if (!memory_read || !memory_write)
+	{
+		update_traps();
+		return;
+	}
+
+	for (unsigned int page = 0; page < 256; page++)
+	{
+		const unsigned int lo = page << 8;
+		const unsigned int hi = lo | 0xFF;
+
+		// 6510 I/O port lives at $0000/$0001
+		if (cpu_model == CPU_6510 && page == 0)
+			continue;
+
+		MemoryReadByte* reader = memory_read;
+		while (reader->lowAddr != (unsigned)-1 && (reader->highAddr < lo || reader->lowAddr > hi))
+			++reader;
+
+		if (reader->lowAddr == (unsigned)-1)
+			base_map.read[page] = mmem ? nullptr : MEM + lo;
+		else if (!reader->memoryCall && reader->lowAddr <= lo && reader->highAddr >= hi)
+			base_map.read[page] = (uint8_t*)reader->pUserArea + (lo - reader->lowAddr);
+
+		MemoryWriteByte* writer = memory_write;
+		while (writer->lowAddr != (unsigned)-1 && (writer->highAddr < lo || writer->lowAddr > hi))
+			++writer;
+
+		if (writer->lowAddr == (unsigned)-1)
+			base_map.write[page] = mmem ? nullptr : MEM + lo;
+		else if (!writer->memoryCall && writer->lowAddr <= lo && writer->highAddr >= hi)
+			base_map.write[page] = (uint8_t*)writer->pUserArea + (lo - writer->lowAddr);
+	}
+
+	update_traps();
+}
+
+// -----------------------------------------------------------------------------
+// map_memory / unmap_memory
+// Bank switching by page table: each page in the range gets its entry pointed
+// at the next 256 bytes of host, or cleared, and nothing is copied. The 6510
+// port page is left alone.
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+bool cpu_6502_core<Hooks, Bus>::map_memory(uint16_t addr, uint32_t size, uint8_t* host, int flags)
+{
+	if ((addr & 0xFF) || (size & 0xFF) || !size || addr + size > 0x10000 || (addrmask & 0xFF) != 0xFF)
+		return false;
+
+	for (unsigned int page = addr >> 8; page < (addr + size) >> 8; page++)
+	{
+		if (!(cpu_model == CPU_6510 && page == 0))
+		{
+			if (flags & MAP_READ) base->read[page] = host;
+			if (flags & MAP_WRITE) base->write[page] = host;
+		}
+		if (host)
+			host += 0x100;
+	}
+
+	// Without watchpoints 'map' is base, so the new entries are already live.
+	if (dbg)
+		update_traps();
+	else
+		flush_code_page();
+	return true;
+}
+
+template <class Hooks, class Bus>
+bool cpu_6502_core<Hooks, Bus>::unmap_memory(uint16_t addr, uint32_t size, int flags)
+{
+	return map_memory(addr, size, nullptr, flags);
+}
+
+// -----------------------------------------------------------------------------
+// dma_copy
+// One block per page. The map is looked up again for every block, so a handler
+// that switches banks part way through is seen by the rest of the transfer.
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+int cpu_6502_core<Hooks, Bus>::dma_copy(uint16_t src, DmaSink dst, void* user, int len, int stall)
+{
+	uint8_t buffer[0x100];
+	uint16_t addr = src & addrmask;
+	int left = len;
+
+	while (left > 0)
+	{
+		const int block = left < 0x100 - (addr & 0xFF) ? left : 0x100 - (addr & 0xFF);
+
+		if (const uint8_t* page = map->read[addr >> 8])
+		{
+			counters.direct_accesses += block;
+			dst(page + (addr & 0xFF), block, user);
+		}
+		else
+		{
+			for (int i = 0; i < block; i++)
+				buffer[i] = read_slow((addr + i) & addrmask);
+			dst(buffer, block, user);
+		}
+
+		addr = (addr + block) & addrmask;
+		left -= block;
+	}
+
+	if (stall < 0)
+	{
+		if (cpu_model == CPU_NES_2A03)
+		{
+			// The cycle after the writing instruction, or now between calls.
+			const uint64_t now = flags_live ? get_cycles() + clockticks6502 + ticks[opcode] : get_cycles();
+			stall = 1 + 2 * len + (int)(now & 1);
+		}
+		else
+			stall = len;
+	}
+
+	counters.stall_cycles += stall;
+	if (flags_live)
+		clockticks6502 += stall;
+	else
+		stall_pending += stall;
+
+	return stall;
+}
+
+// -----------------------------------------------------------------------------
+// RDY stalls
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+bool cpu_6502_core<Hooks, Bus>::add_rdy_stall(uint64_t at, int cycles)
+{
+	if (cycles <= 0)
+		return false;
+
+	auto pos = std::upper_bound(rdy_stalls.begin(), rdy_stalls.end(), at,
+		[](uint64_t a, const RdyStall& s) { return a < s.at; });
+	rdy_stalls.insert(pos, { at, cycles });
+	return true;
+}
+
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::idle6502(int cycles)
+{
+	clocktickstotal += cycles;
+	counters.cycles += cycles;
+	hooks.on_stall(*this, cycles);
+}
+
+template <class Hooks, class Bus>
+int cpu_6502_core<Hooks, Bus>::take_stall()
+{
+	const int stall = stall_pending;
+	stall_pending = 0;
+	idle6502(stall);
+	return stall;
+}
+
+// What a window doesn't get to now stays at the front, due at once.
+template <class Hooks, class Bus>
+int cpu_6502_core<Hooks, Bus>::take_rdy(int limit)
+{
+	RdyStall& window = rdy_stalls.front();
+	const int stall = window.cycles < limit ? window.cycles : limit;
+
+	window.cycles -= stall;
+	if (!window.cycles)
+		rdy_stalls.erase(rdy_stalls.begin());
+
+	counters.stall_cycles += stall;
+	idle6502(stall);
+	return stall;
+}
+
+// -----------------------------------------------------------------------------
+// debug_location
+// The host byte backing addr: the active map page, a handler's pUserArea, or MEM.
+// Null for the 6510 port, or when there is no MEM behind an unhandled address.
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+uint8_t* cpu_6502_core<Hooks, Bus>::debug_location(uint16_t addr) const
+{
+	addr &= addrmask;
+
+	if (cpu_model == CPU_6510 && addr < 2)
+		return nullptr;
+
+	// The base map, not the trap map, so watched pages stay fast.
+	if (base->read[addr >> 8])
+		return base->read[addr >> 8] + (addr & 0xFF);
+
+	if constexpr (Bus::fixed)
+	{
+		const int i = Bus::find(addr);
+		if (i < 0)
+			return nullptr;
+	}
+	else if (memory_read)
+	{
+		for (const MemoryReadByte* reader = memory_read; reader->lowAddr != (unsigned)-1; ++reader)
+		{
+			if (addr >= reader->lowAddr && addr <= reader->highAddr)
+			{
+				if (!reader->memoryCall)
+					return (uint8_t*)reader->pUserArea + (addr - reader->lowAddr);
+				break;
+			}
+		}
+	}
+
+	return MEM ? MEM + addr : nullptr;
+}
+
+// -----------------------------------------------------------------------------
+// peek / poke
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+uint8_t cpu_6502_core<Hooks, Bus>::peek(uint16_t addr) const
+{
+	addr &= addrmask;
+
+	if (cpu_model == CPU_6510 && addr < 2)
+		return addr == 0 ? ddr : (port_out & ddr) | (port_in & ~ddr);
+
+	if constexpr (Bus::fixed)
+	{
+		const int i = Bus::find(addr);
+		if (!base->read[addr >> 8] && i >= 0 && Bus::ranges[i].read == BUS_IO)
+		{
+			const int data = bus.io_peek(Bus::ranges[i].device, (uint16_t)(addr - Bus::ranges[i].lo));
+			if (data >= 0)
+				return (uint8_t)data;
+		}
+	}
+	else if (!base->read[addr >> 8] && memory_read)
+	{
+		for (MemoryReadByte* reader = memory_read; reader->lowAddr != (unsigned)-1; ++reader)
+		{
+			if (addr >= reader->lowAddr && addr <= reader->highAddr)
+			{
+				if (reader->memoryCall && reader->debugCall)
+					return reader->debugCall(addr - reader->lowAddr, reader);
+				break;
+			}
+		}
+	}
+
+	const uint8_t* p = debug_location(addr);
+	return p ? *p : 0;
+}
+
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::poke(uint16_t addr, uint8_t byte)
+{
+	uint8_t* p = debug_location(addr);
+	if (p)
+		*p = byte;
+}
+
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::check_and_notify_6510(uint8_t old_ddr, uint8_t old_port)
+{
+	if (port_cb)
+	{
+		// Calculate Effective Output (What the PLA/MMU sees)
+		// The MMU only cares about bits driven as Output.
+		uint8_t old_eff = old_port & old_ddr;
+		uint8_t new_eff = port_out & ddr;
+
+		// Only trigger callback if the effective banking bits actually changed.
+		// This saves CPU cycles by not rebuilding the memory map on useless writes.
+		if (old_eff != new_eff) {
+			port_cb(port_out, ddr);
+		}
+	}
+}
+
+// -----------------------------------------------------------------------------
+// 6510 port maps. The PLA sees the pins: output bits from the latch, input bits
+// from outside (pulled high by default).
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+bool cpu_6502_core<Hooks, Bus>::set_6510_memory_maps(const cpu6502_memory_map* maps, uint8_t mask)
+{
+	if (!maps)
+	{
+		port_maps.clear();
+		base = &base_map;
+		update_traps();
+		return true;
+	}
+
+	if (cpu_model != CPU_6510 || (mask & (mask + 1)))
+		return false;
+
+	port_maps.assign(maps, maps + mask + 1);
+	for (cpu6502_memory_map& m : port_maps)
+		m.read[0] = m.write[0] = nullptr;
+	port_map_mask = mask;
+
+	select_6510_map();
+	return true;
+}
+
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::select_6510_map()
+{
+	if (port_maps.empty())
+		return;
+
+	const uint8_t pins = (port_out & ddr) | (port_in & ~ddr);
+	base = &port_maps[pins & port_map_mask];
+
+	if (dbg)
+		update_traps();
+	else
+	{
+		map = base;
+		flush_code_page();
+	}
+}
+
+// -----------------------------------------------------------------------------
+// Callback Hook After CLI Instruction.
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::check_interrupts_after_cli()
+{
+	// block IRQ recognition for exactly the next instruction
+	irq_inhibit_one = 2;
+}
+
+// -----------------------------------------------------------------------------
+// Check Whether a Pending IRQ Should Be Taken Now.
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::maybe_take_irq()
+{
+	if (_irqPending && !(P & F_I))
+		irq6502(0);
+}
+
+// -----------------------------------------------------------------------------
+// Clear the Pending IRQ Flag.
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::m6502clearpendingint()
+{
+	_irqPending = 0;
+}
+
+// -----------------------------------------------------------------------------
+// Get the value of a CPU register by register index.
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+uint8_t cpu_6502_core<Hooks, Bus>::m6502_get_reg(int regnum)
+{
+	switch (regnum)
+	{
+	case M6502_S: return S;
+	case M6502_P: return get_p();
+	case M6502_A: return A;
+	case M6502_X: return X;
+	case M6502_Y: return Y;
+	default: return 0;
+	}
+}
+
+// -----------------------------------------------------------------------------
+// Set the value of a CPU register by register index.
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::m6502_set_reg(int regnum, uint8_t val)
+{
+	switch (regnum)
+	{
+	case M6502_S: S = val; break;
+	case M6502_P: set_p(val); break;
+	case M6502_A: A = val; break;
+	case M6502_X: X = val; break;
+	case M6502_Y: Y = val; break;
+	default: break;
+	}
+}
+
+// -----------------------------------------------------------------------------
+// Get the current value of the program counter (PC).
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+uint16_t cpu_6502_core<Hooks, Bus>::get_pc()
+{
+	return PC;
+}
+
+// -----------------------------------------------------------------------------
+// Get the previous value of the program counter (PPC).
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+uint16_t cpu_6502_core<Hooks, Bus>::get_ppc()
+{
+	return PPC;
+}
+
+// -----------------------------------------------------------------------------
+// Set the program counter (PC) to a new address.
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::set_pc(uint16_t pc)
+{
+	PC = pc;
+}
+
+// -----------------------------------------------------------------------------
+// Reset the CPU to its initial state.
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::reset6502()
+{
+	LOG_INFO("6502 Reset");
+
+	A = X = Y = 0;
+	set_p(F_T | F_I | F_Z);
+	_irqPending = 0;
+
+	PC = PPC = 0;
+	_irqPending = 0;
+	clocktickstotal = 0;
+
+	S = 0xFF;
+
+	PC = get6502memory(0xFFFC & addrmask);
+	PC |= get6502memory(0xFFFD & addrmask) << 8;
+
+	LOG_INFO("reset: PC is %X", PC);
+	clockticks6502 += 6;
+
+	if (cpu_model == CPU_6510) {
+		ddr = 0x00;       // Hardware resets to 0 (Input)
+		port_out = 0x00;
+		port_in = 0xFF;   // Inputs usually pulled high
+
+		// Note: The C64 KERNAL ROM will write 0x2F and 0x37 shortly after boot.
+		// We don't need to force it here, let the ROM do it.
+	}
+}
+
+// -----------------------------------------------------------------------------
+// Internal Helper: Actually take the interrupt, push stack, change PC.
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::execute_irq()
+{
+	push16(PC);
+	push8(get_p() & ~F_B);
+	P |= F_I;
+	PC = get6502memory(0xFFFE & addrmask);
+	PC |= get6502memory(0xFFFF & addrmask) << 8;
+	hooks.on_irq(*this, INT_IRQ, PC);
+
+	clockticks6502 += 7;
+	clocktickstotal += 7;
+	counters.cycles += 7;
+	counters.irqs++;
+
+	if (_irqMode == IRQ_PULSE)
+	{
+		_irqPending = 0;
+	}
+}
+
+// -----------------------------------------------------------------------------
+// Assert the IRQ Line.
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::irq6502(int irqmode)
+{
+	_irqPending = 1;
+	_irqMode = irqmode;
+}
+
+// -----------------------------------------------------------------------------
+// Execute a non-maskable interrupt (NMI).
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::nmi6502()
+{
+	push16(PC);
+	push8(get_p() & ~F_B);
+	P |= F_I;
+	PC = get6502memory(0xFFFA & addrmask);
+	PC |= get6502memory(0xFFFB & addrmask) << 8;
+	hooks.on_irq(*this, INT_NMI, PC);
+	clockticks6502 += 7;
+	clocktickstotal += 7;
+	counters.cycles += 7;
+	counters.nmis++;
+}
+
+// -----------------------------------------------------------------------------
+// Push a 16-bit value to the 6502 stack (high byte first).
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::push16(uint16_t val)
+{
+	put6502memory(BASE_STACK + S, (val >> 8) & 0xFF);
+	put6502memory(BASE_STACK + ((S - 1) & 0xFF), val & 0xFF);
+	S -= 2;
+}
+
+// -----------------------------------------------------------------------------
+// Push an 8-bit value to the 6502 stack.
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::push8(uint8_t val)
+{
+	put6502memory(BASE_STACK + S--, val);
+}
+
+// -----------------------------------------------------------------------------
+// Pull a 16-bit value from the 6502 stack (low byte first).
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+uint16_t cpu_6502_core<Hooks, Bus>::pull16()
+{
+	uint16_t val = get6502memory(BASE_STACK + ((S + 1) & 0xFF)) |
+		(static_cast<uint16_t>(get6502memory(BASE_STACK + ((S + 2) & 0xFF))) << 8);
+	S += 2;
+	return val;
+}
+
+// -----------------------------------------------------------------------------
+// Pull an 8-bit value from the 6502 stack.
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+uint8_t cpu_6502_core<Hooks, Bus>::pull8()
+{
+	return get6502memory(BASE_STACK + ++S);
+}
+
+// -----------------------------------------------------------------------------
+// Execute Instructions Until the Specified Timer Threshold is Reached.
+// Returns the Number of Cycles Executed.
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+int cpu_6502_core<Hooks, Bus>::exec6502(int timerTicks)
+{
+	hooks.on_exec_begin(*this, timerTicks);
+	unpack_flags();
+
+	int cycles = stall_pending ? take_stall() : 0;
+	if (rdy_stalls.empty())
+		cycles += exec_slice(timerTicks - cycles);
+	else
+		cycles += exec6502_rdy(timerTicks - cycles);
+
+	pack_flags();
+	hooks.on_exec_end(*this, cycles);
+	return cycles;
+}
+
+// -----------------------------------------------------------------------------
+// Run instructions until budget cycles have passed, in whichever loop applies.
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+int cpu_6502_core<Hooks, Bus>::exec_slice(int budget)
+{
+	int cycles = 0;
+	if (dbg)
+		cycles = exec6502_debug(budget);
+	else if (superinstructions)
+	{
+		while (cycles < budget)
+			cycles += step6502_fused(budget - cycles);
+	}
+	else
+	{
+		while (cycles < budget)
+			cycles += execute_instruction();
+	}
+	return cycles;
+}
+
+// -----------------------------------------------------------------------------
+// exec6502 with RDY windows scheduled. Each slice ends at the next window's
+// start, so the window is taken at the first instruction boundary at or after it.
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+int cpu_6502_core<Hooks, Bus>::exec6502_rdy(int budget)
+{
+	int cycles = 0;
+
+	while (cycles < budget)
+	{
+		if (rdy_stalls.empty())
+			return cycles + exec_slice(budget - cycles);
+
+		if (is_stopped())
+			break;
+
+		if (rdy_stalls.front().at <= get_cycles())
+		{
+			cycles += take_rdy(budget - cycles);
+			continue;
+		}
+
+		const uint64_t gap = rdy_stalls.front().at - get_cycles();
+		const int slice = gap < (uint64_t)(budget - cycles) ? (int)gap : budget - cycles;
+		const int ran = exec_slice(slice);
+		if (!ran)
+			break; // Stopped in the debugger
+		cycles += ran;
+	}
+
+	return cycles;
+}
+
+// -----------------------------------------------------------------------------
+// Execute loop used while breakpoints are set. Checks the execute trap bitmap
+// before each instruction and stops after any instruction that hit a watchpoint.
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+int cpu_6502_core<Hooks, Bus>::exec6502_debug(int timerTicks)
+{
+	int cycles = 0;
+
+	if (dbg->stop.reason != STOP_NONE)
+		return 0;
+
+	// Condition callbacks may clear the breakpoints, so re-check dbg each time.
+	while (cycles < timerTicks && dbg)
+	{
+		if ((dbg->trap_flags[(PC & addrmask) >> 8] & TRAP_EXEC) && check_breakpoint(PC))
+			break;
+
+		if (dbg)
+			dbg->skip_break_once = false;
+		cycles += execute_instruction();
+
+		if (dbg && dbg->stop.reason != STOP_NONE)
+			break;
+	}
+
+	while (cycles < timerTicks && !dbg)
+		cycles += execute_instruction();
+
+	return cycles;
+}
+
+// -----------------------------------------------------------------------------
+// Breakpoints and Watchpoints
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+int cpu_6502_core<Hooks, Bus>::add_breakpoint(uint16_t addr, BreakCondition cond, void* user)
+{
+	if (!dbg)
+		dbg = std::make_unique<DebugState>();
+
+	const int id = dbg->next_id++;
+	dbg->points.push_back({ id, addr, addr, TRAP_EXEC, cond, user });
+	update_traps();
+	return id;
+}
+
+template <class Hooks, class Bus>
+int cpu_6502_core<Hooks, Bus>::add_watchpoint(uint16_t lo, uint16_t hi, int flags, BreakCondition cond, void* user)
+{
+	int traps = 0;
+	if (flags & WATCH_READ) traps |= TRAP_READ;
+	if (flags & WATCH_WRITE) traps |= TRAP_WRITE;
+	if (!traps || hi < lo)
+		return 0;
+
+	if (!dbg)
+		dbg = std::make_unique<DebugState>();
+
+	const int id = dbg->next_id++;
+	dbg->points.push_back({ id, lo, hi, traps, cond, user });
+	update_traps();
+	return id;
+}
+
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::remove_breakpoint(int id)
+{
+	if (!dbg)
+		return;
+
+	for (auto it = dbg->points.begin(); it != dbg->points.end(); ++it)
+	{
+		if (it->id == id)
+		{
+			dbg->points.erase(it);
+			break;
+		}
+	}
+
+	if (dbg->points.empty() && dbg->stop.reason == STOP_NONE)
+		clear_breakpoints();
+	else
+		update_traps();
+}
+
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::clear_breakpoints()
+{
+	dbg.reset();
+	update_traps();
+}
+
+template <class Hooks, class Bus>
+const cpu6502_stop_info& cpu_6502_core<Hooks, Bus>::get_stop_info() const
+{
+	static const cpu6502_stop_info none;
+	return dbg ? dbg->stop : none;
+}
+
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::resume()
+{
+	if (!dbg)
+		return;
+
+	// Don't stop again on the breakpoint we are sitting on.
+	dbg->skip_break_once = (dbg->stop.reason == STOP_BREAKPOINT);
+	dbg->stop = cpu6502_stop_info();
+
+	if (dbg->points.empty())
+		clear_breakpoints();
+}
+
+// -----------------------------------------------------------------------------
+// Recompute the per page trap flags, and point the access paths at the trap
+// map (the base map with watched pages unmapped) while anything is watched.
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::update_traps()
+{
+	flush_code_page();
+
+	if (!dbg)
+	{
+		map = base;
+		return;
+	}
+
+	std::fill(std::begin(dbg->trap_flags), std::end(dbg->trap_flags), 0);
+	for (const Breakpoint& bp : dbg->points)
+	{
+		for (unsigned int page = (bp.lo & addrmask) >> 8; page <= (unsigned int)((bp.hi & addrmask) >> 8); page++)
+			dbg->trap_flags[page] |= bp.flags;
+	}
+
+	bool watched = false;
+	dbg->trap_map = *base;
+	for (int page = 0; page < 256; page++)
+	{
+		if (dbg->trap_flags[page] & TRAP_READ) { dbg->trap_map.read[page] = nullptr; watched = true; }
+		if (dbg->trap_flags[page] & TRAP_WRITE) { dbg->trap_map.write[page] = nullptr; watched = true; }
+	}
+
+	map = watched ? &dbg->trap_map : base;
+}
+
+// -----------------------------------------------------------------------------
+// Where a scan of dbg->points carries on after point 'id', found at index i
+// before its condition ran. The condition may have removed points, 'id'
+// included, so the index is looked up again; when 'id' is gone, the next scan
+// step lands on whatever moved into its slot.
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+int cpu_6502_core<Hooks, Bus>::rescan_index(int i, int id) const
+{
+	if (i < (int)dbg->points.size() && dbg->points[i].id == id)
+		return i;
+
+	for (int j = 0; j < (int)dbg->points.size(); j++)
+	{
+		if (dbg->points[j].id == id)
+			return j;
+	}
+	return i - 1;
+}
+
+// -----------------------------------------------------------------------------
+// Called before executing at addr on a page with execute traps.
+// Returns true if the CPU should stop.
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+bool cpu_6502_core<Hooks, Bus>::check_breakpoint(uint16_t addr)
+{
+	if (dbg->skip_break_once)
+		return false;
+
+	addr &= addrmask;
+	for (int i = 0; i < (int)dbg->points.size(); i++)
+	{
+		// A copy, the condition may add or remove points.
+		const Breakpoint bp = dbg->points[i];
+		if (!(bp.flags & TRAP_EXEC) || (bp.lo & addrmask) != addr)
+			continue;
+
+		const uint8_t op = peek(addr);
+		if (bp.cond)
+		{
+			const bool hit = bp.cond(this, addr, op, bp.user);
+			if (!dbg)
+				return false; // The condition cleared every breakpoint
+			i = rescan_index(i, bp.id);
+			if (!hit)
+				continue;
+		}
+
+		dbg->stop.reason = STOP_BREAKPOINT;
+		dbg->stop.id = bp.id;
+		dbg->stop.addr = addr;
+		dbg->stop.data = op;
+		dbg->stop.pc = addr;
+		return true;
+	}
+	return false;
+}
+
+// -----------------------------------------------------------------------------
+// Called from the slow access paths on watched pages. A hit records the stop,
+// the current instruction still completes.
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::check_watchpoints(uint16_t addr, uint8_t data, int flag)
+{
+	if (dbg->stop.reason != STOP_NONE)
+		return;
+
+	for (int i = 0; i < (int)dbg->points.size(); i++)
+	{
+		// A copy, the condition may add or remove points.
+		const Breakpoint bp = dbg->points[i];
+		if (!(bp.flags & flag) || addr < (bp.lo & addrmask) || addr > (bp.hi & addrmask))
+			continue;
+
+		if (bp.cond)
+		{
+			const bool hit = bp.cond(this, addr, data, bp.user);
+			if (!dbg)
+				return; // The condition cleared every breakpoint
+			i = rescan_index(i, bp.id);
+			if (!hit)
+				continue;
+		}
+
+		dbg->stop.reason = (flag == TRAP_READ) ? STOP_WATCH_READ : STOP_WATCH_WRITE;
+		dbg->stop.id = bp.id;
+		dbg->stop.addr = addr;
+		dbg->stop.data = data;
+		dbg->stop.pc = PPC - 1;
+		return;
+	}
+}
+
+
+// -----------------------------------------------------------------------------
+// Execute a Single 6502 Instruction.
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+int cpu_6502_core<Hooks, Bus>::step6502()
+{
+	unpack_flags();
+	int cycles = stall_pending ? take_stall() : 0;
+	while (!rdy_stalls.empty() && rdy_stalls.front().at <= get_cycles())
+		cycles += take_rdy(rdy_stalls.front().cycles);
+	cycles += execute_instruction();
+	pack_flags();
+	return cycles;
+}
+
+// -----------------------------------------------------------------------------
+// One instruction or interrupt entry, with the flags already unpacked.
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+int cpu_6502_core<Hooks, Bus>::execute_instruction()
+{
+	clockticks6502 = 0;
+
+	bool interrupts_allowed = (irq_inhibit_one == 0) && !(P & F_I);
+
+	// Check for IRQ
+	if (_irqPending && interrupts_allowed) {
+		execute_irq();
+
+		if (irq_inhibit_one > 0) irq_inhibit_one--;
+		return clockticks6502;
+	}
+	else if (_irqPending && irq_inhibit_one && !(P & F_I))
+		counters.irqs_deferred++;
+
+	// Normal Instruction Fetch
+	const uint16_t pc = PC;
+	opcode = code_read(PC++);
+	P |= F_T;
+
+	hooks.on_fetch(*this, pc, opcode);
+
+	PPC = PC;
+
+	(this->*opcode_table[opcode].addressing_mode)();
+	(this->*opcode_table[opcode].instruction)();
+
+	retire6502(pc);
+
+	return clockticks6502;
+}
+
+// -----------------------------------------------------------------------------
+// Cycle and counter bookkeeping at the end of every instruction.
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+inline void cpu_6502_core<Hooks, Bus>::retire6502(uint16_t pc)
+{
+	clockticks6502 += ticks[opcode];
+	clocktickstotal += clockticks6502;
+	counters.instructions++;
+	counters.cycles += clockticks6502;
+
+	if (instruction_count)
+		instruction_count[opcode]++;
+
+	hooks.on_retire(*this, pc, opcode, clockticks6502);
+
+	if (clocktickstotal > 0x0FFFFFFF)
+		clocktickstotal = 0;
+
+	if (irq_inhibit_one > 0)
+		irq_inhibit_one--;
+}
+
+// -----------------------------------------------------------------------------
+// Superinstructions
+// The usual compare/branch, count/branch and load/store idioms. cpu_6502_sequence.h
+// reports which pairs a game really runs. Sorted by first opcode. INC zp / BNE
+// also runs the INC zp+1 of a 16 bit increment when the branch falls through.
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+const typename cpu_6502_core<Hooks, Bus>::FusedPair cpu_6502_core<Hooks, Bus>::fused_pairs[] = {
+	{ 0x88, 0xD0, 1, 3, &cpu_6502_core::template fused_dec_bne<FUSED_Y> },                 // DEY / BNE
+	{ 0xA5, 0x85, 2, 4, &cpu_6502_core::template fused_load_store<FUSED_ZP, FUSED_ZP> },   // LDA zp / STA zp
+	{ 0xA5, 0x8D, 2, 5, &cpu_6502_core::template fused_load_store<FUSED_ZP, FUSED_ABS> },  // LDA zp / STA abs
+	{ 0xA9, 0x85, 2, 4, &cpu_6502_core::template fused_load_store<FUSED_IMM, FUSED_ZP> },  // LDA # / STA zp
+	{ 0xA9, 0x8D, 2, 5, &cpu_6502_core::template fused_load_store<FUSED_IMM, FUSED_ABS> }, // LDA # / STA abs
+	{ 0xAD, 0x85, 3, 5, &cpu_6502_core::template fused_load_store<FUSED_ABS, FUSED_ZP> },  // LDA abs / STA zp
+	{ 0xAD, 0x8D, 3, 6, &cpu_6502_core::template fused_load_store<FUSED_ABS, FUSED_ABS> }, // LDA abs / STA abs
+	{ 0xC0, 0xD0, 2, 4, &cpu_6502_core::template fused_cmp_branch<FUSED_Y, false> },       // CPY # / BNE
+	{ 0xC0, 0xF0, 2, 4, &cpu_6502_core::template fused_cmp_branch<FUSED_Y, true> },        // CPY # / BEQ
+	{ 0xC9, 0xD0, 2, 4, &cpu_6502_core::template fused_cmp_branch<FUSED_A, false> },       // CMP # / BNE
+	{ 0xC9, 0xF0, 2, 4, &cpu_6502_core::template fused_cmp_branch<FUSED_A, true> },        // CMP # / BEQ
+	{ 0xCA, 0xD0, 1, 3, &cpu_6502_core::template fused_dec_bne<FUSED_X> },                 // DEX / BNE
+	{ 0xE0, 0xD0, 2, 4, &cpu_6502_core::template fused_cmp_branch<FUSED_X, false> },       // CPX # / BNE
+	{ 0xE0, 0xF0, 2, 4, &cpu_6502_core::template fused_cmp_branch<FUSED_X, true> },        // CPX # / BEQ
+	{ 0xE6, 0xD0, 2, 4, &cpu_6502_core::fused_inc_bne },                                   // INC zp / BNE (/ INC zp+1)
+	{ 0, 0, 0, 0, nullptr }
+};
+
+// -----------------------------------------------------------------------------
+// Fill a model's fused_first. A pair is skipped if the model replaced either opcode.
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::build_fused_table(ModelTables& tables)
+{
+	memset(tables.fused_first, 0, sizeof(tables.fused_first));
+
+	auto stock = [&tables](uint8_t op) {
+		return tables.ops[op].instruction == initial_opcode_table[op].instruction &&
+			tables.ops[op].addressing_mode == initial_opcode_table[op].addressing_mode;
+	};
+
+	for (int i = 0; fused_pairs[i].handler; i++)
+	{
+		if (!tables.fused_first[fused_pairs[i].first])
+			tables.fused_first[fused_pairs[i].first] = (uint8_t)(i + 1);
+	}
+
+	for (int i = 0; fused_pairs[i].handler; i++)
+	{
+		if (!stock(fused_pairs[i].first) || !stock(fused_pairs[i].second))
+			tables.fused_first[fused_pairs[i].first] = 0;
+	}
+}
+
+// -----------------------------------------------------------------------------
+// Execute one instruction, or a fused sequence when the next opcodes form one.
+// Only exec6502's normal loop uses this. The code page is looked up the same
+// way code_read does, and a sequence only runs if all of its bytes are on it.
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+int cpu_6502_core<Hooks, Bus>::step6502_fused(int budget)
+{
+	// Interrupt entry and the instruction after CLI stay in step6502.
+	if (irq_inhibit_one || (_irqPending && !(P & F_I)))
+		return execute_instruction();
+
+	const uint16_t pc = PC & addrmask;
+	if ((pc >> 8) != code_page_index)
+	{
+		code_page_index = pc >> 8;
+		code_page = map->read[code_page_index];
+	}
+
+	if (!code_page)
+		return execute_instruction();
+
+	const int offset = pc & 0xFF;
+	const uint8_t* code = code_page + offset;
+	if (fused_first[code[0]])
+	{
+		for (const FusedPair* f = &fused_pairs[fused_first[code[0]] - 1]; f->first == code[0]; f++)
+		{
+			if (offset + f->size <= 0x100 && code[f->length] == f->second)
+				return (this->*f->handler)(code, budget);
+		}
+	}
+
+	// Anything else runs here as in execute_instruction, whose checks are done.
+	const uint16_t start = PC;
+	fused_fetch(start, code[0]);
+	counters.direct_accesses++;
+
+	(this->*opcode_table[opcode].addressing_mode)();
+	(this->*opcode_table[opcode].instruction)();
+
+	retire6502(start);
+	return clockticks6502;
+}
+
+// -----------------------------------------------------------------------------
+// Fused instruction steps. Opcode and operand bytes come straight from the code
+// page the sequence was matched on. Each instruction still calls the hooks and
+// retires on its own, so counters, hook policies, the AAE timer and the DMA
+// cycle parity see the same stream as step6502.
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+inline void cpu_6502_core<Hooks, Bus>::fused_fetch(uint16_t pc, uint8_t op)
+{
+	clockticks6502 = 0;
+	opcode = op;
+	PC = (uint16_t)(pc + 1);
+	P |= F_T;
+	hooks.on_fetch(*this, pc, op);
+	PPC = PC;
+}
+
+template <class Hooks, class Bus>
+template <int Mode>
+inline uint16_t cpu_6502_core<Hooks, Bus>::fused_address(const uint8_t* code, uint16_t pc)
+{
+	hooks.on_read(*this, (pc + 1) & addrmask, code[1]);
+	if constexpr (Mode == FUSED_ZP)
+		return code[1];
+
+	hooks.on_read(*this, (pc + 2) & addrmask, code[2]);
+	return code[1] | (code[2] << 8);
+}
+
+template <class Hooks, class Bus>
+template <int Mode>
+inline uint8_t cpu_6502_core<Hooks, Bus>::fused_load(const uint8_t* code, uint16_t pc)
+{
+	if constexpr (Mode == FUSED_IMM)
+	{
+		hooks.on_read(*this, (pc + 1) & addrmask, code[1]);
+		return code[1];
+	}
+	else
+	{
+		savepc = fused_address<Mode>(code, pc);
+		return get6502memory(savepc);
+	}
+}
+
+template <class Hooks, class Bus>
+template <int Reg>
+inline uint8_t& cpu_6502_core<Hooks, Bus>::fused_reg()
+{
+	if constexpr (Reg == FUSED_X)
+		return X;
+	else if constexpr (Reg == FUSED_Y)
+		return Y;
+	else
+		return A;
+}
+
+// Every byte of the instruction was a direct code page read.
+template <class Hooks, class Bus>
+inline int cpu_6502_core<Hooks, Bus>::fused_retire(uint16_t pc, int length)
+{
+	counters.direct_accesses += length;
+	retire6502(pc);
+	return clockticks6502;
+}
+
+// The sequence ends early where the loop would have stopped or taken an IRQ,
+// if a handler or hook changed the memory map, or if the next opcode was
+// rewritten since the sequence was matched.
+template <class Hooks, class Bus>
+inline bool cpu_6502_core<Hooks, Bus>::fused_stop(int cycles, int budget, uint8_t next, uint8_t expected) const
+{
+	return cycles >= budget || (_irqPending && !(P & F_I)) || code_page_index == 0x100 || next != expected;
+}
+
+template <class Hooks, class Bus>
+inline int cpu_6502_core<Hooks, Bus>::fused_branch(const uint8_t* code, uint16_t pc, bool taken)
+{
+	fused_fetch(pc, code[0]);
+	hooks.on_read(*this, (pc + 1) & addrmask, code[1]);
+	savepc = (uint16_t)(int8_t)code[1];
+	PC = (uint16_t)(pc + 2);
+	branch6502(taken);
+	return fused_retire(pc, 2);
+}
+
+template <class Hooks, class Bus>
+inline int cpu_6502_core<Hooks, Bus>::fused_inc_zp(const uint8_t* code, uint16_t pc)
+{
+	fused_fetch(pc, code[0]);
+	savepc = fused_address<FUSED_ZP>(code, pc);
+	PC = (uint16_t)(pc + 2);
+	const RmwAccess rmw = rmw_read();
+	const uint8_t result = rmw.data + 1;
+	rmw_write(rmw, result);
+	set_nz(result);
+	return fused_retire(pc, 2);
+}
+
+// -----------------------------------------------------------------------------
+// CMP/CPX/CPY # followed by BEQ or BNE.
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+template <int Reg, bool Equal>
+int cpu_6502_core<Hooks, Bus>::fused_cmp_branch(const uint8_t* code, int budget)
+{
+	const uint16_t pc = PC;
+	fused_fetch(pc, code[0]);
+	PC = (uint16_t)(pc + 2);
+	value = fused_load<FUSED_IMM>(code, pc);
+
+	const uint8_t reg = fused_reg<Reg>();
+	if (reg >= value)
+		P |= F_C;
+	else
+		P &= ~F_C;
+	set_nz(reg - value);
+
+	const int cycles = fused_retire(pc, 2);
+	if (fused_stop(cycles, budget, code[2], Equal ? 0xF0 : 0xD0))
+		return cycles;
+
+	return cycles + fused_branch(code + 2, (uint16_t)(pc + 2), Equal ? flag_z == 0 : flag_z != 0);
+}
+
+// -----------------------------------------------------------------------------
+// DEX or DEY followed by BNE, the counted loop.
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+template <int Reg>
+int cpu_6502_core<Hooks, Bus>::fused_dec_bne(const uint8_t* code, int budget)
+{
+	const uint16_t pc = PC;
+	fused_fetch(pc, code[0]);
+
+	uint8_t& reg = fused_reg<Reg>();
+	reg--;
+	set_nz(reg);
+
+	const int cycles = fused_retire(pc, 1);
+	if (fused_stop(cycles, budget, code[1], 0xD0))
+		return cycles;
+
+	return cycles + fused_branch(code + 1, (uint16_t)(pc + 1), flag_z != 0);
+}
+
+// -----------------------------------------------------------------------------
+// LDA #, zp or abs followed by STA zp or abs.
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+template <int Load, int Store>
+int cpu_6502_core<Hooks, Bus>::fused_load_store(const uint8_t* code, int budget)
+{
+	const int length = Load == FUSED_ABS ? 3 : 2;
+	const uint16_t pc = PC;
+	fused_fetch(pc, code[0]);
+	PC = (uint16_t)(pc + length);
+	A = fused_load<Load>(code, pc);
+	set_nz(A);
+
+	const int cycles = fused_retire(pc, length);
+	if (fused_stop(cycles, budget, code[length], Store == FUSED_ABS ? 0x8D : 0x85))
+		return cycles;
+
+	const uint16_t pc2 = (uint16_t)(pc + length);
+	fused_fetch(pc2, code[length]);
+	savepc = fused_address<Store>(code + length, pc2);
+	PC = (uint16_t)(pc2 + (Store == FUSED_ABS ? 3 : 2));
+	put6502memory(savepc, A);
+
+	return cycles + fused_retire(pc2, Store == FUSED_ABS ? 3 : 2);
+}
+
+// -----------------------------------------------------------------------------
+// INC zp / BNE, and the INC zp+1 after it when the low byte wrapped:
+//   INC lo / BNE +2 / INC lo+1
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+int cpu_6502_core<Hooks, Bus>::fused_inc_bne(const uint8_t* code, int budget)
+{
+	const uint16_t pc = PC;
+	int cycles = fused_inc_zp(code, pc);
+	if (fused_stop(cycles, budget, code[2], 0xD0))
+		return cycles;
+
+	cycles += fused_branch(code + 2, (uint16_t)(pc + 2), flag_z != 0);
+
+	if (flag_z == 0 && (pc & 0xFF) <= 0xFA && code[3] == 0x02 && code[5] == (uint8_t)(code[1] + 1) &&
+		!fused_stop(cycles, budget, code[4], 0xE6))
+		cycles += fused_inc_zp(code + 4, (uint16_t)(pc + 4));
+
+	return cycles;
+}
+
+// -----------------------------------------------------------------------------
+// Addressing Modes
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::abs6502()
+{
+	savepc = fetch16();
+	PC += 2;
+}
+
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::immediate6502()
+{
+	savepc = PC++;
+}
+
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::implied6502()
+{
+	// NOP (handled inside instruction)
+}
+
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::relative6502()
+{
+	savepc = fetch8();
+	if (savepc & 0x80)
+		savepc |= 0xFF00;
+}
+
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::indirect6502()
+{
+	uint16_t addr_ptr = fetch16();
+	uint16_t lo = addr_ptr;
+	uint16_t hi = addr_ptr + 1;
+
+	// Handle Page Boundary Bug for NMOS only (NES is also NMOS-based)
+	if (cpu_model != CPU_CMOS_65C02 && (lo & 0x00FF) == 0x00FF)
+	{
+		hi = lo & 0xFF00; // Wrap to beginning of page
+	}
+	if (cpu_model == CPU_CMOS_65C02) {
+		clockticks6502++;
+	}
+	savepc = get6502memory(lo) | (get6502memory(hi) << 8);
+	PC += 2;
+}
+
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::absx6502()
+{
+	savepc = fetch16();
+	if (ticks[opcode] == 4 && ((savepc ^ (savepc + X)) & 0xFF00))
+	{
+		clockticks6502++;
+		counters.page_cross_cycles++;
+	}
+	savepc += X;
+	PC += 2;
+}
+
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::absy6502()
+{
+	savepc = fetch16();
+	if (ticks[opcode] == 4 && ((savepc ^ (savepc + Y)) & 0xFF00))
+	{
+		clockticks6502++;
+		counters.page_cross_cycles++;
+	}
+	savepc += Y;
+	PC += 2;
+}
+
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::zp6502()
+{
+	savepc = fetch8();
+}
+
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::zpx6502()
+{
+	savepc = (fetch8() + X) & 0xFF;
+}
+
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::zpy6502()
+{
+	savepc = (fetch8() + Y) & 0xFF;
+}
+
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::indx6502()
+{
+	value = (fetch8() + X) & 0xFF;
+	savepc = get6502memory(value) | (get6502memory((value + 1) & 0xFF) << 8);
+}
+
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::indy6502()
+{
+	uint16_t temp;
+	value = fetch8();
+	temp = (value & 0xFF00) | ((value + 1) & 0x00FF);  //zero-page wraparound
+	savepc = get6502memory(value) | (get6502memory(temp) << 8);
+	if (ticks[opcode] == 5)
+		if ((savepc >> 8) != ((savepc + Y) >> 8))
+		{
+			clockticks6502++; //one cycle penlty for page-crossing on some opcodes
+			counters.page_cross_cycles++;
+		}
+	savepc += Y;
+}
+
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::indabsx6502()
+{
+	help = fetch16();
+	help += X;
+	savepc = get6502memory(help) | (get6502memory(help + 1) << 8);
+}
+
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::indzp6502()
+{
+	value = fetch8();
+	savepc = get6502memory(value) | (get6502memory((value + 1) & 0xFF) << 8);
+
+	// 65C02 Fix: These instructions take 5 cycles.
+	// The static ticks[] table usually has '2' for these slots.
+	// We add 3 extra cycles here to correct it.
+	if (cpu_model == CPU_CMOS_65C02) {
+		clockticks6502 += 3;
+	}
+}
+
+// -----------------------------------------------------------------------------
+// Zero Page Relative (65C02 Bit Branching)
+// Fetches ZP Address into 'help' and Relative Offset into 'savepc'
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::zprel6502()
+{
+	help = fetch8(); // Zero Page Address
+	savepc = fetch8(); // Relative Offset
+	if (savepc & 0x80)
+		savepc |= 0xFF00; // Sign extend
+}
+
+// -----------------------------------------------------------------------------
+// NES 2A03 Arithmetic Implementations (Binary Only)
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::adc_2a03()
+{
+	const uint8_t m = get6502memory(savepc);
+	const int     cin = (P & F_C) ? 1 : 0;
+	const uint16_t sum = (uint16_t)A + m + cin;
+	const uint8_t  bin = (uint8_t)sum;
+
+	P &= ~(F_V | F_C);
+	if ((~(A ^ m) & (A ^ bin) & 0x80) != 0) P |= F_V;
+	if (sum & 0x0100) P |= F_C;
+
+	A = bin;
+	set_nz(A);
+}
+
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::sbc_2a03()
+{
+	const uint8_t m = get6502memory(savepc);
+	const int     cin = (P & F_C) ? 1 : 0;
+	const uint16_t diff = (uint16_t)A - m - (1 - cin);
+	const uint8_t  bin = (uint8_t)diff;
+
+	P &= ~(F_V | F_C);
+	if (((A ^ m) & (A ^ bin) & 0x80) != 0) P |= F_V;
+	if (!(diff & 0x0100)) P |= F_C;
+
+	A = bin;
+	set_nz(A);
+}
+
+// -----------------------------------------------------------------------------
+// CMOS 65C02 Arithmetic Implementations (Decimal Flag Fix)
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::adc65c02()
+{
+	const uint8_t m = get6502memory(savepc);
+	const int     cin = (P & F_C) ? 1 : 0;
+	const uint16_t sum = (uint16_t)A + m + cin;
+	const uint8_t  bin = (uint8_t)sum;
+
+	P &= ~(F_V | F_C);
+	if ((~(A ^ m) & (A ^ bin) & 0x80) != 0) P |= F_V;
+
+	if (P & F_D)
+	{
+		clockticks6502++;
+		const bcd_result& dec = bcd_adc.entry[sum | (((A ^ m ^ sum) & 0x10) << 5)];
+		P |= dec.carry;
+		A = dec.value;
+		set_nz(A);
+	}
+	else
+	{
+		if (sum & 0x0100) P |= F_C;
+		A = bin;
+		set_nz(A);
+	}
+}
+
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::sbc65c02()
+{
+	const uint8_t m = get6502memory(savepc);
+	const int     cin = (P & F_C) ? 1 : 0;
+	const uint16_t diff = (uint16_t)A - m - (1 - cin);
+	const uint8_t  bin = (uint8_t)diff;
+
+	P &= ~(F_V | F_C);
+	if (((A ^ m) & (A ^ bin) & 0x80) != 0) P |= F_V;
+
+	if (P & F_D)
+	{
+		clockticks6502++;
+		const bcd_result& dec = bcd_sbc.entry[(diff & 0x1FF) | (((A ^ m ^ diff) & 0x10) << 5)];
+		P |= dec.carry;
+		A = dec.value;
+		set_nz(A);
+	}
+	else
+	{
+		if (!(diff & 0x0100)) P |= F_C;
+		A = bin;
+		set_nz(A);
+	}
+}
+
+// -----------------------------------------------------------------------------
+// Standard NMOS Arithmetic Implementations
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+inline void cpu_6502_core<Hooks, Bus>::adc6502()
+{
+	const uint8_t m = get6502memory(savepc);
+	const int     cin = (P & F_C) ? 1 : 0;
+	const uint16_t sum = (uint16_t)A + m + cin;
+	const uint8_t  bin = (uint8_t)sum;
+
+	P &= ~(F_V | F_C);
+	if ((~(A ^ m) & (A ^ bin) & 0x80) != 0) P |= F_V;
+
+	if (P & F_D)
+	{
+		const bcd_result& dec = bcd_adc.entry[sum | (((A ^ m ^ sum) & 0x10) << 5)];
+		P |= dec.carry;
+		A = dec.value;
+	}
+	else
+	{
+		if (sum & 0x0100) P |= F_C;
+		A = bin;
+	}
+	set_nz(bin);
+}
+
+template <class Hooks, class Bus>
+inline void cpu_6502_core<Hooks, Bus>::sbc6502()
+{
+	const uint8_t m = get6502memory(savepc);
+	const int     cin = (P & F_C) ? 1 : 0;
+	const uint16_t diff = (uint16_t)A - m - (1 - cin);
+	const uint8_t  bin = (uint8_t)diff;
+
+	P &= ~(F_V | F_C);
+	if (((A ^ m) & (A ^ bin) & 0x80) != 0) P |= F_V;
+
+	if (P & F_D)
+	{
+		const bcd_result& dec = bcd_sbc.entry[(diff & 0x1FF) | (((A ^ m ^ diff) & 0x10) << 5)];
+		P |= dec.carry;
+		A = dec.value;
+	}
+	else
+	{
+		if (!(diff & 0x0100)) P |= F_C;
+		A = bin;
+	}
+	set_nz(bin);
+}
+
+// -----------------------------------------------------------------------------
+// Bitwise AND
+// Performs a logical AND between the accumulator (A) and memory.
+// Updates the zero and negative flags based on the result.
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::and6502()
+{
+	value = get6502memory(savepc);
+	A &= value;
+	set_nz(A);
+}
+
+// -----------------------------------------------------------------------------
+// Bitwise Exclusive OR (EOR)
+// Performs a logical exclusive OR between the accumulator (A) and memory.
+// Updates the zero and negative flags based on the result.
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::eor6502()
+{
+	A ^= get6502memory(savepc);
+	set_nz(A);
+}
+
+// -----------------------------------------------------------------------------
+// Bitwise OR (ORA)
+// Performs a logical inclusive OR between the accumulator (A) and memory.
+// Updates the zero and negative flags based on the result.
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::ora6502()
+{
+	A |= get6502memory(savepc);
+	set_nz(A);
+}
+
+// -----------------------------------------------------------------------------
+// BIT (Bit Test)
+// Tests bits in memory against the accumulator (A).
+// Sets the zero flag if (A & M) == 0.
+// Sets the negative and overflow flags from memory bits 7 and 6 respectively.
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::bit6502()
+{
+	value = get6502memory(savepc);
+
+	// 65C02 Specific: Immediate Mode ($89) ONLY touches the Z flag.
+	// All other modes (ZeroPage, Absolute, etc) touch N, V, and Z.
+	if (cpu_model == CPU_CMOS_65C02 && opcode == 0x89)
+	{
+		// Immediate mode: Only update Z
+		set_z(A & value);
+	}
+	else
+	{
+		// Standard behavior (NMOS and CMOS non-immediate)
+		// N and V from bits 7 and 6 of memory
+		flag_n = value;
+		P = (P & ~F_V) | (value & F_V);
+
+		// Z if (A & value) == 0
+		flag_z = A & value;
+	}
+}
+// -----------------------------------------------------------------------------
+// Compare (CMP)
+// Compares the accumulator (A) with memory and sets flags as if performing
+// A - M, without storing the result.
+// Updates carry, zero, and negative flags.
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::cmp6502()
+{
+	value = get6502memory(savepc);
+	if (A >= value)
+		P |= F_C;
+	else
+		P &= ~F_C;
+	set_nz(A - value);
+}
+
+// -----------------------------------------------------------------------------
+// Compare X Register (CPX)
+// Compares the X register with memory and sets flags as if performing
+// X - M, without storing the result.
+// Updates carry, zero, and negative flags.
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::cpx6502()
+{
+	value = get6502memory(savepc);
+
+	// Set Carry if X >= value
+	if (X >= value)
+		P |= F_C;
+	else
+		P &= ~F_C;
+
+	set_nz(X - value);
+}
+
+// -----------------------------------------------------------------------------
+// Compare Y Register (CPY)
+// Compares the Y register with memory and sets flags as if performing
+// Y - M, without storing the result.
+// Updates carry, zero, and negative flags.
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::cpy6502()
+{
+	value = get6502memory(savepc);
+
+	// Set Carry if Y >= value
+	if (Y >= value)
+		P |= F_C;
+	else
+		P &= ~F_C;
+
+	set_nz(Y - value);
+}
+
+// -----------------------------------------------------------------------------
+// Load Accumulator
+// Loads a value from memory into the accumulator (A) and sets the zero and
+// negative flags based on the result.
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+inline void cpu_6502_core<Hooks, Bus>::lda6502()
+{
+	A = get6502memory(savepc);
+	set_nz(A);
+}
+
+// -----------------------------------------------------------------------------
+// Load X Register
+// Loads a value from memory into the X register and sets the zero and
+// negative flags based on the result.
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::ldx6502()
+{
+	X = get6502memory(savepc);
+	set_nz(X);
+}
+
+// -----------------------------------------------------------------------------
+// Load Y Register
+// Loads a value from memory into the Y register and sets the zero and
+// negative flags based on the result.
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::ldy6502()
+{
+	Y = get6502memory(savepc);
+	set_nz(Y);
+}
+
+// -----------------------------------------------------------------------------
+// Store Accumulator
+// Stores the value of the accumulator (A) into memory.
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::sta6502()
+{
+	put6502memory(savepc, A);
+}
+
+// -----------------------------------------------------------------------------
+// Store X Register
+// Stores the value of the X register into memory.
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::stx6502()
+{
+	put6502memory(savepc, X);
+}
+
+// -----------------------------------------------------------------------------
+// Store Y Register
+// Stores the value of the Y register into memory.
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::sty6502()
+{
+	put6502memory(savepc, Y);
+}
+
+// -----------------------------------------------------------------------------
+// Store Zero (65C02)
+// Stores a zero value into memory. This is a 65C02 extension instruction.
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::stz6502()
+{
+	put6502memory(savepc, 0);
+}
+
+// -----------------------------------------------------------------------------
+// Increment Memory
+// Increments the value at the specified memory location and sets the zero and
+// negative flags based on the result.
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::inc6502()
+{
+	const RmwAccess rmw = rmw_read();
+	uint8_t result = rmw.data + 1;
+	rmw_write(rmw, result);
+	set_nz(result);
+}
+
+// -----------------------------------------------------------------------------
+// Decrement Memory
+// Decrements the value at the specified memory location and sets the zero and
+// negative flags based on the result.
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::dec6502()
+{
+	const RmwAccess rmw = rmw_read();
+	uint8_t result = rmw.data - 1;
+	rmw_write(rmw, result);
+	set_nz(result);
+}
+
+// -----------------------------------------------------------------------------
+// Increment X
+// Increments the X register and sets the zero and negative flags based on the result.
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::inx6502()
+{
+	X++;
+	set_nz(X);
+}
+
+// -----------------------------------------------------------------------------
+// Decrement X
+// Decrements the X register and sets the zero and negative flags based on the result.
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::dex6502()
+{
+	X--;
+	set_nz(X);
+}
+
+// -----------------------------------------------------------------------------
+// Increment Y
+// Increments the Y register and sets the zero and negative flags based on the result.
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::iny6502()
+{
+	Y++;
+	set_nz(Y);
+}
+
+// -----------------------------------------------------------------------------
+// Decrement Y
+// Decrements the Y register and sets the zero and negative flags based on the result.
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::dey6502()
+{
+	Y--;
+	set_nz(Y);
+}
+
+// -----------------------------------------------------------------------------
+// Increment A (Unofficial)
+// Increments the accumulator (A) and sets the zero and negative flags based on the result.
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::ina6502()
+{
+	A++;
+	set_nz(A);
+}
+
+// -----------------------------------------------------------------------------
+// Decrement A (Unofficial)
+// Decrements the accumulator (A) and sets the zero and negative flags based on the result.
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::dea6502()
+{
+	A--;
+	set_nz(A);
+}
+
+// -----------------------------------------------------------------------------
+// Logical Shift Left (Memory)
+// Performs a logical shift left on a memory value, stores the result back, and
+// sets the carry, zero, and negative flags accordingly.
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::asl6502()
+{
+	const RmwAccess rmw = rmw_read();
+	value = rmw.data;
+	P = (P & ~F_C) | ((value >> 7) & F_C);
+	value <<= 1;
+	rmw_write(rmw, value);
+	set_nz(value);
+}
+
+// -----------------------------------------------------------------------------
+// Logical Shift Left (Accumulator)
+// Performs a logical shift left on the accumulator (A) and sets the carry,
+// zero, and negative flags accordingly.
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::asla6502()
+{
+	P = (P & ~F_C) | ((A >> 7) & F_C);
+	A <<= 1;
+	set_nz(A);
+}
+
+// -----------------------------------------------------------------------------
+// Logical Shift Right (Memory)
+// Shifts memory value right by 1. Carry flag is set to bit 0 before the shift.
+// The result is stored back at the same memory location.
+// Updates the Zero and Negative flags (N is always 0).
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::lsr6502()
+{
+	const RmwAccess rmw = rmw_read();
+	value = rmw.data;
+	P = (P & ~F_C) | (value & F_C);
+	value >>= 1;
+	rmw_write(rmw, value);
+	set_nz(value);
+}
+
+// -----------------------------------------------------------------------------
+// Logical Shift Right (Accumulator)
+// Shifts the accumulator (A) one bit to the right (logical shift).
+// The low bit is moved into the carry flag. Bit 7 is set to 0.
+// Updates the carry, zero, and negative flags.
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::lsra6502()
+{
+	P = (P & ~F_C) | (A & F_C);
+	A >>= 1;
+	set_nz(A);
+}
+
+// -----------------------------------------------------------------------------
+// Rotate Left (Memory)
+// Rotates a memory value one bit to the left through the carry flag.
+// Bit 7 moves into carry, carry moves into bit 0.
+// Updates the carry, zero, and negative flags.
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::rol6502()
+{
+	saveflags = P & F_C;
+	const RmwAccess rmw = rmw_read();
+	value = rmw.data;
+	P = (P & ~F_C) | ((value >> 7) & F_C);
+	value = (value << 1) | saveflags;
+	rmw_write(rmw, value);
+	set_nz(value);
+}
+
+// -----------------------------------------------------------------------------
+// Rotate Left (Accumulator)
+// Rotates the accumulator (A) one bit to the left through the carry flag.
+// Bit 7 moves into carry, carry moves into bit 0.
+// Updates the carry, zero, and negative flags.
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::rola6502()
+{
+	saveflags = P & F_C;
+	P = (P & ~F_C) | ((A >> 7) & F_C);
+	A = (A << 1) | saveflags;
+	set_nz(A);
+}
+
+// -----------------------------------------------------------------------------
+// Rotate Right (Memory)
+// Rotates a memory value one bit to the right through the carry flag.
+// Bit 0 moves into carry, carry moves into bit 7.
+// Updates the carry, zero, and negative flags.
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::ror6502()
+{
+	saveflags = P & F_C;
+	const RmwAccess rmw = rmw_read();
+	value = rmw.data;
+	P = (P & ~F_C) | (value & F_C);
+	value >>= 1;
+	if (saveflags) value |= F_N;
+	rmw_write(rmw, value);
+	set_nz(value);
+}
+
+// -----------------------------------------------------------------------------
+// Rotate Right (Accumulator)
+// Rotates the accumulator (A) one bit to the right through the carry flag.
+// Bit 0 moves into carry, carry moves into bit 7.
+// Updates the carry, zero, and negative flags.
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::rora6502()
+{
+	saveflags = P & F_C;
+	P = (P & ~F_C) | (A & F_C);
+	A >>= 1;
+	if (saveflags) A |= F_N;
+	set_nz(A);
+}
+
+// -----------------------------------------------------------------------------
+// Branch if Carry Clear
+// Adds signed offset from operand if Carry flag is clear.
+// Increments clockticks by 1 if branch is on same page,
+// or by 2 if it crosses a page boundary.
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+inline void cpu_6502_core<Hooks, Bus>::bcc6502()
+{
+	branch6502((P & F_C) == 0);
+}
+
+// -----------------------------------------------------------------------------
+// Branch if Carry Set (BCS)
+// Branches to a relative address if the carry flag is set.
+// Adds 1 cycle if branch occurs on the same page, 2 if it crosses a page.
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+inline void cpu_6502_core<Hooks, Bus>::bcs6502()
+{
+	branch6502((P & F_C) != 0);
+}
+
+// -----------------------------------------------------------------------------
+// Branch if Equal (BEQ)
+// Branches to a relative address if the zero flag is set (A == M).
+// Adds 1 cycle if branch occurs on the same page, 2 if it crosses a page.
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+inline void cpu_6502_core<Hooks, Bus>::beq6502()
+{
+	branch6502(flag_z == 0);
+}
+
+// -----------------------------------------------------------------------------
+// Branch if Minus (BMI)
+// Branches to a relative address if the negative flag is set (result < 0).
+// Adds 1 cycle if branch occurs on the same page, 2 if it crosses a page.
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+inline void cpu_6502_core<Hooks, Bus>::bmi6502()
+{
+	branch6502((flag_n & F_N) != 0);
+}
+
+// -----------------------------------------------------------------------------
+// Branch if Not Equal (BNE)
+// Branches to a relative address if the zero flag is clear (A != M).
+// Adds 1 cycle if branch occurs on the same page, 2 if it crosses a page.
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+inline void cpu_6502_core<Hooks, Bus>::bne6502()
+{
+	branch6502(flag_z != 0);
+}
+
+// -----------------------------------------------------------------------------
+// Branch if Positive (BPL)
+// Branches to a relative address if the negative flag is clear (result >= 0).
+// Adds 1 cycle if branch occurs on the same page, 2 if it crosses a page.
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::bpl6502()
+{
+	branch6502((flag_n & F_N) == 0);
+}
+
+// -----------------------------------------------------------------------------
+// Branch if Overflow Clear (BVC)
+// Branches to a relative address if the overflow flag is clear.
+// Adds 1 cycle if branch occurs on the same page, 2 if it crosses a page.
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::bvc6502()
+{
+	branch6502((P & F_V) == 0);
+}
+
+// -----------------------------------------------------------------------------
+// Branch if Overflow Set (BVS)
+// Branches to a relative address if the overflow flag is set.
+// Adds 1 cycle if branch occurs on the same page, 2 if it crosses a page.
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::bvs6502()
+{
+	branch6502((P & F_V) != 0);
+}
+
+// -----------------------------------------------------------------------------
+// Branch Always (BRA) - 65C02 Only
+// Unconditionally branches to a relative address.
+// Adds 1 clock cycle to the base instruction timing.
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+inline void cpu_6502_core<Hooks, Bus>::bra6502()
+{
+	PC += (int8_t)(savepc);
+	clockticks6502++;
+}
+// -----------------------------------------------------------------------------
+// Jump (JMP)
+// Sets the program counter to the target address specified by savepc.
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+inline void cpu_6502_core<Hooks, Bus>::jmp6502()
+{
+	PC = savepc;
+}
+
+// -----------------------------------------------------------------------------
+// Jump to Subroutine (JSR)
+// Pushes the return address (PC - 1) onto the stack and jumps to the target
+// address specified by savepc.
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+inline void cpu_6502_core<Hooks, Bus>::jsr6502()
+{
+	PC--;
+	push16(PC);
+	PC = savepc;
+}
+
+// -----------------------------------------------------------------------------
+// Return from Subroutine (RTS)
+// Pops the return address from the stack and sets the program counter to it,
+// then increments the program counter by 1.
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+inline void cpu_6502_core<Hooks, Bus>::rts6502()
+{
+	PC = pull16();
+	PC++;
+}
+
+// -----------------------------------------------------------------------------
+// Return from Interrupt (RTI)
+// Pops the processor status and program counter from the stack.
+// Restores the CPU state after an interrupt handler has completed.
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::rti6502()
+{
+	const bool was_I = (P & F_I) != 0;
+	set_p(pull8() | F_T | F_B);
+	PC = pull16();
+	if (was_I && !(P & F_I)) irq_inhibit_one = 2;
+}
+
+// -----------------------------------------------------------------------------
+// Break (BRK)
+// Forces an interrupt (software interrupt).
+// Pushes the program counter and processor status onto the stack,
+// sets the interrupt disable flag, and loads the interrupt vector from $FFFE.
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::brk6502()
+{
+	PC++;
+	push16(PC);
+	// Ensure both Bit 4 (B) and Bit 5 (T) are set
+	push8(get_p() | F_B | F_T);
+	P = (P | F_I) & ~F_D;
+	PC = get6502memory(0xFFFE & addrmask) | (get6502memory(0xFFFF & addrmask) << 8);
+}
+
+// -----------------------------------------------------------------------------
+// No Operation (NOP)
+// Performs no operation. Some undocumented NOPs add timing delay.
+// Logs a warning if the NOP opcode is unofficial.
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::nop6502()
+	{
+		// Official NOP
+		if (opcode == 0xEA) return;
+
+		// Ignore known 65C02 valid NOPs to clean up logs
+		if (cpu_model == CPU_CMOS_65C02) {
+			// 1-byte NOPs (converted from NMOS undoc)
+			if ((opcode & 0x0F) == 0x03 || (opcode & 0x0F) == 0x0B) return;
+			// 2-byte and 3-byte NOPs
+			if ((opcode & 0x0F) == 0x02 || (opcode & 0x0F) == 0x04) return;
+			if (opcode == 0x5C || opcode == 0xDC || opcode == 0xFC) return;
+		}
+
+		LOG_INFO_RL("!!!!WARNING UNHANDLED NO-OP CALLED: %02X CPU: %d", opcode, cpu_num);
+
+	// 2. Handle Cycle Adjustments (if any are missing from ticks table)
+	// Most standard NOP timings are handled by the ticks[] table, 
+	// but some NOPs referencing page boundaries might need +1 here if desired.
+	// For functional tests, base table timing is usually sufficient.
+}
+
+// -----------------------------------------------------------------------------
+// Clear Carry Flag (CLC)
+// Clears the carry flag (C = 0).
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::clc6502()
+{
+	P &= ~F_C;
+}
+
+// -----------------------------------------------------------------------------
+// Clear Decimal Mode (CLD)
+// Clears the decimal mode flag (D = 0), disabling BCD arithmetic.
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::cld6502()
+{
+	P &= ~F_D;
+}
+
+// -----------------------------------------------------------------------------
+// Clear Interrupt Disable (CLI)
+// Clears the interrupt disable flag (I = 0), enabling maskable IRQs.
+// Also checks for any pending interrupts that were deferred.
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::cli6502()
+{
+	// --- CLI: defer IRQ for one instruction if I actually transitions 1->0 (NMOS) ---
+	const bool was_I = (P & F_I) != 0;
+	P &= ~F_I;
+	if (was_I) check_interrupts_after_cli();
+}
+
+// -----------------------------------------------------------------------------
+// Clear Overflow Flag (CLV)
+// Clears the overflow flag (V = 0).
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::clv6502()
+{
+	P &= ~F_V;
+}
+
+// -----------------------------------------------------------------------------
+// Set Carry Flag (SEC)
+// Sets the carry flag (C = 1).
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::sec6502()
+{
+	P |= F_C;
+}
+
+// -----------------------------------------------------------------------------
+// Set Decimal Mode (SED)
+// Sets the decimal mode flag (D = 1), enabling BCD arithmetic.
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::sed6502()
+{
+	P |= F_D;
+}
+
+// -----------------------------------------------------------------------------
+// Set Interrupt Disable (SEI)
+// Sets the interrupt disable flag (I = 1), preventing maskable IRQs.
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::sei6502()
+{
+	P |= F_I;
+}
+
+// -----------------------------------------------------------------------------
+// Transfer Accumulator to X (TAX)
+// Copies the accumulator (A) into the X register.
+// Updates the zero and negative flags based on the result.
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::tax6502()
+{
+	X = A;
+	set_nz(X);
+}
+
+// -----------------------------------------------------------------------------
+// Transfer Accumulator to Y (TAY)
+// Copies the accumulator (A) into the Y register.
+// Updates the zero and negative flags based on the result.
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::tay6502()
+{
+	Y = A;
+	set_nz(Y);
+}
+
+// -----------------------------------------------------------------------------
+// Transfer X to Accumulator (TXA)
+// Copies the X register into the accumulator (A).
+// Updates the zero and negative flags based on the result.
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::txa6502()
+{
+	A = X;
+	set_nz(A);
+}
+
+// -----------------------------------------------------------------------------
+// Transfer Y to Accumulator (TYA)
+// Copies the Y register into the accumulator (A).
+// Updates the zero and negative flags based on the result.
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::tya6502()
+{
+	A = Y;
+	set_nz(A);
+}
+
+// -----------------------------------------------------------------------------
+// Transfer Stack Pointer to X (TSX)
+// Copies the stack pointer (S) into the X register.
+// Updates the zero and negative flags based on the result.
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::tsx6502()
+{
+	X = S;
+	set_nz(X);
+}
+
+// -----------------------------------------------------------------------------
+// Transfer X to Stack Pointer (TXS)
+// Copies the X register into the stack pointer (S).
+// Does not affect any flags.
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::txs6502()
+{
+	S = X;
+}
+
+// -----------------------------------------------------------------------------
+// Push Accumulator (PHA)
+// Pushes the accumulator (A) onto the stack.
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::pha6502()
+{
+	push8(A);
+}
+
+// -----------------------------------------------------------------------------
+// Push Processor Status (PHP)
+// Pushes the processor status register (P) onto the stack.
+// The break flag is set in the value pushed.
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::php6502()
+{
+	// Ensure both Bit 4 (B) and Bit 5 (T) are set
+	push8(get_p() | F_B | F_T);
+}
+
+// -----------------------------------------------------------------------------
+// Pull Accumulator (PLA)
+// Pulls a byte from the stack into the accumulator (A).
+// Updates the zero and negative flags based on the result.
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::pla6502()
+{
+	A = pull8();
+	set_nz(A);
+}
+
+// -----------------------------------------------------------------------------
+// Pull Processor Status (PLP)
+// Pulls a byte from the stack into the processor status register (P).
+// The unused flag (T) is forced on.
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::plp6502()
+{
+	const bool was_I = (P & F_I) != 0;
+	set_p(pull8() | F_T | F_B);
+	if (was_I && !(P & F_I)) irq_inhibit_one = 2;
+}
+
+// -----------------------------------------------------------------------------
+// Push X Register (PHX) - 65C02/undocumented
+// Pushes the X register onto the stack.
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::phx6502()
+{
+	push8(X);
+}
+
+// -----------------------------------------------------------------------------
+// Pull X Register (PLX) - 65C02/undocumented
+// Pulls a byte from the stack into the X register.
+// Updates the zero and negative flags based on the result.
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::plx6502()
+{
+	X = pull8();
+	set_nz(X);
+}
+
+// -----------------------------------------------------------------------------
+// Push Y Register (PHY) - 65C02/undocumented
+// Pushes the Y register onto the stack.
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::phy6502()
+{
+	push8(Y);
+}
+
+// -----------------------------------------------------------------------------
+// Pull Y Register (PLY) - 65C02/undocumented
+// Pulls a byte from the stack into the Y register.
+// Updates the zero and negative flags based on the result.
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::ply6502()
+{
+	Y = pull8();
+	set_nz(Y);
+}
+
+// -----------------------------------------------------------------------------
+// LAX Instruction (Undocumented)
+//
+// Loads memory into both the A and X registers simultaneously.
+// Affects: N, Z
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+inline void cpu_6502_core<Hooks, Bus>::lax6502()
+{
+	A = X = get6502memory(savepc);
+	set_nz(A);
+}
+
+// -----------------------------------------------------------------------------
+// SAX Instruction (Undocumented)
+//
+// Stores A & X to memory. Combines A and X registers with bitwise AND.
+// Affects: None
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+inline void cpu_6502_core<Hooks, Bus>::sax6502()
+{
+	put6502memory(savepc, A & X);
+}
+
+// -----------------------------------------------------------------------------
+// TRB (Test and Reset Bits)
+// Tests bits in memory against the accumulator (A).
+// Sets the zero flag if (A & M) == 0.
+// Clears bits in memory where A has 1s (M = M & ~A).
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::trb6502()
+{
+	const RmwAccess rmw = rmw_read();
+	uint8_t v = rmw.data;
+	set_z(A & v);
+	rmw_write(rmw, v & ~A);
+}
+
+// -----------------------------------------------------------------------------
+// TSB (Test and Set Bits)
+// Tests bits in memory against the accumulator (A).
+// Sets the zero flag if (A & M) == 0.
+// Sets bits in memory where A has 1s (M = M | A).
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::tsb6502()
+{
+	const RmwAccess rmw = rmw_read();
+	uint8_t v = rmw.data;
+	set_z(A & v);
+	rmw_write(rmw, v | A);
+}
+
+// -----------------------------------------------------------------------------
+// DCP Instruction (Undocumented)
+//
+// Decrements memory, then compares the result with A as if performing CMP.
+// Affects: N, Z, C
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+inline void cpu_6502_core<Hooks, Bus>::dcp6502()
+{
+	const RmwAccess rmw = rmw_read();
+	uint8_t m = rmw.data - 1;
+	rmw_write(rmw, m);
+	uint16_t result = (uint16_t)A - m;
+	P = (P & ~F_C) | ((result < 0x100) ? F_C : 0);
+	set_nz((uint8_t)result);
+}
+
+// -----------------------------------------------------------------------------
+// NES 2A03: RRA (Undocumented, Binary Only)
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::rra_2a03()
+{
+	uint8_t carry_in = (P & F_C) ? 0x80 : 0;
+	const RmwAccess rmw = rmw_read();
+	value = rmw.data;
+	P = (P & ~F_C) | (value & 1);
+	value = (value >> 1) | carry_in;
+	rmw_write(rmw, value);
+
+	// ADC (Binary) logic
+	const uint8_t m = value;
+	const int cin = (P & F_C) ? 1 : 0;
+	const uint16_t sum = (uint16_t)A + m + cin;
+
+	P &= ~(F_V | F_C);
+	if ((~(A ^ m) & (A ^ (uint8_t)sum) & 0x80) != 0) P |= F_V;
+	if (sum & 0x0100) P |= F_C;
+
+	A = (uint8_t)sum;
+	set_nz(A);
+}
+
+// -----------------------------------------------------------------------------
+// NES 2A03: ISC (Undocumented, Binary Only)
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::isc_2a03()
+{
+	const RmwAccess rmw = rmw_read();
+	uint8_t m = rmw.data + 1;
+	rmw_write(rmw, m);
+
+	// SBC (Binary) logic
+	const int cin = (P & F_C) ? 1 : 0;
+	const uint16_t diff = (uint16_t)A - m - (1 - cin);
+
+	P &= ~(F_V | F_C);
+	if (((A ^ m) & (A ^ (uint8_t)diff) & 0x80) != 0) P |= F_V;
+	if (!(diff & 0x0100)) P |= F_C;
+
+	A = (uint8_t)diff;
+	set_nz(A);
+}
+
+// -----------------------------------------------------------------------------
+// NMOS Undocumented: ISC (With BCD Support)
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::isc6502()
+{
+	const RmwAccess rmw = rmw_read();
+	uint8_t m = rmw.data + 1;
+	rmw_write(rmw, m);
+
+	// SBC Logic (NMOS)
+	const int cin = (P & F_C) ? 1 : 0;
+	const uint16_t diff = (uint16_t)A - m - (1 - cin);
+	const uint8_t  bin = (uint8_t)diff;
+
+	P &= ~(F_V | F_C);
+	if (((A ^ m) & (A ^ bin) & 0x80) != 0) P |= F_V;
+
+	if (P & F_D)
+	{
+		const bcd_result& dec = bcd_sbc.entry[(diff & 0x1FF) | (((A ^ m ^ diff) & 0x10) << 5)];
+		P |= dec.carry;
+		A = dec.value;
+	}
+	else
+	{
+		if (!(diff & 0x0100)) P |= F_C;
+		A = bin;
+	}
+	set_nz(bin); // NMOS: Flags on Binary Result
+}
+
+template <class Hooks, class Bus>
+inline void cpu_6502_core<Hooks, Bus>::slo6502()
+{
+	const RmwAccess rmw = rmw_read();
+	value = rmw.data;
+	P = (P & ~F_C) | (value >> 7);
+	value <<= 1;
+	rmw_write(rmw, value);
+	A |= value;
+	set_nz(A);
+}
+
+// -----------------------------------------------------------------------------
+// NMOS Undocumented: RRA (With BCD Support)
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::rra6502()
+{
+	uint8_t carry_in = (P & F_C) ? 0x80 : 0;
+	const RmwAccess rmw = rmw_read();
+	value = rmw.data;
+	P = (P & ~F_C) | (value & 1);
+	value = (value >> 1) | carry_in;
+	rmw_write(rmw, value);
+
+	// ADC Logic (NMOS)
+	const uint8_t m = value;
+	const int     cin = (P & F_C) ? 1 : 0;
+	const uint16_t sum = (uint16_t)A + m + cin;
+	const uint8_t  bin = (uint8_t)sum;
+
+	P &= ~(F_V | F_C);
+	if ((~(A ^ m) & (A ^ bin) & 0x80) != 0) P |= F_V;
+
+	if (P & F_D)
+	{
+		const bcd_result& dec = bcd_adc.entry[sum | (((A ^ m ^ sum) & 0x10) << 5)];
+		P |= dec.carry;
+		A = dec.value;
+	}
+	else
+	{
+		if (sum & 0x0100) P |= F_C;
+		A = bin;
+	}
+	set_nz(bin); // NMOS: Flags on Binary Result
+}
+
+// -----------------------------------------------------------------------------
+// RLA Instruction (Undocumented)
+//
+// Performs a left shift on memory (ASL), then ANDs the result with A.
+// Equivalent to: ASL + AND
+// Affects: N, Z, C
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+inline void cpu_6502_core<Hooks, Bus>::rla6502()
+{
+	const RmwAccess rmw = rmw_read();
+	value = rmw.data;
+
+	// Save the bit that will become the new carry
+	uint8_t new_carry = (value >> 7) & 1;
+
+	// Get the old carry to rotate into bit 0
+	uint8_t old_carry = (P & F_C) ? 1 : 0;
+
+	// Perform ROL: shift left and rotate old carry into bit 0
+	value = (value << 1) | old_carry;
+
+	// Update carry flag with bit that was shifted out
+	P = (P & ~F_C) | (new_carry ? F_C : 0);
+
+	// Write back to memory
+	rmw_write(rmw, value);
+
+	// AND with accumulator
+	A &= value;
+	set_nz(A);
+}
+
+// -----------------------------------------------------------------------------
+// SRE Instruction (Undocumented)
+//
+// Performs a logical shift right (LSR) on memory, then EORs the result with A.
+// Equivalent to: LSR + EOR
+// Affects: N, Z, C
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+inline void cpu_6502_core<Hooks, Bus>::sre6502()
+{
+	const RmwAccess rmw = rmw_read();
+	value = rmw.data;
+	P = (P & ~F_C) | (value & 0x01); // Set Carry from bit 0
+	value >>= 1;
+	rmw_write(rmw, value);
+
+	A ^= value;
+	set_nz(A);
+}
+
+// -----------------------------------------------------------------------------
+// RMB0-7 and SMB0-7 (65C02)
+// Reset/Set Memory Bit. 
+// Cycle count: 5
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::rmb_smb_6502()
+{
+	// savepc contains the Zero Page address (fetched by zp6502 mode)
+	const RmwAccess rmw = rmw_read();
+	uint8_t val = rmw.data;
+
+	// Decode Bit (High nibble 0-7) and Action (High nibble bit 3)
+	// RMB: 0x07, 17, 27... SMB: 0x87, 97, A7...
+	uint8_t bit_mask = 1 << ((opcode >> 4) & 7);
+
+	if (opcode & 0x80) {
+		val |= bit_mask;  // SMB (Set)
+	}
+	else {
+		val &= ~bit_mask; // RMB (Reset)
+	}
+
+	rmw_write(rmw, val);
+}
+
+// -----------------------------------------------------------------------------
+// BBR0-7 and BBS0-7 (65C02)
+// Branch on Bit Reset/Set.
+// Cycle count: 5 + 1 if branch + 1 if page cross
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::bbr_bbs_6502()
+{
+	// Hardware base is 5 cycles. 
+   // The ticks[] table for 'xF' (SLO abs) is usually 6.
+   // Correction:
+	clockticks6502 -= 1;
+
+	// help contains ZP address, savepc contains relative offset (fetched by zprel6502)
+	uint8_t val = get6502memory(help);
+
+	// Decode Bit
+	uint8_t bit_mask = 1 << ((opcode >> 4) & 7);
+
+	// Check condition
+	// BBR (0x0F..7F): Branch if Clear. BBS (0x8F..FF): Branch if Set.
+	bool condition = (val & bit_mask);
+
+	// If Opcode has bit 7 set (BBS), we want condition true.
+	// If Opcode has bit 7 clear (BBR), we want condition false.
+	if (((opcode & 0x80) != 0) == condition)
+	{
+		oldpc = PC;
+		PC += (int8_t)savepc;
+
+		// Standard branch timing: +1 for taking it
+		clockticks6502++;
+
+		// +1 for page crossing (standard behavior for 65C02 branches)
+		if ((oldpc ^ PC) & 0xFF00)
+		{
+			clockticks6502++;
+			counters.page_cross_cycles++;
+		}
+		counters.branches_taken++;
+	}
+	else
+		counters.branches_not_taken++;
+}
+// -----------------------------------------------------------------------------
+// More undocumented NMOS Instructions
+// -----------------------------------------------------------------------------
+
+// ANC - AND with immediate, then set C = N
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::anc6502()
+{
+	value = get6502memory(savepc);
+	A &= value;
+	set_nz(A);
+	// Carry = bit7(A)
+	if (A & 0x80) P |= F_C; else P &= ~F_C;
+}
+
+// ALR - AND immediate, then LSR
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::alr6502()
+{
+	value = get6502memory(savepc);
+	A &= value;
+	P = (P & ~F_C) | (A & 0x01 ? F_C : 0);
+	A >>= 1;
+	set_nz(A);
+}
+
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::arr6502()
+{
+	value = get6502memory(savepc);
+	A &= value;
+
+	// Perform ROR on A (rotate right through carry)
+	uint8_t old_carry = (P & F_C) ? 0x80 : 0;
+	A = (A >> 1) | old_carry;
+
+	set_nz(A);
+
+	// ARR has unique flag behavior in binary mode:
+	// C = bit 6 of result
+	// V = bit 6 XOR bit 5 of result
+	P &= ~(F_C | F_V);
+
+	if (A & 0x40)
+		P |= F_C;
+
+	if (((A >> 6) ^ (A >> 5)) & 0x01)
+		P |= F_V;
+
+	// Note: Decimal mode ARR is even more complex. (TODO: SO FIX THIS)
+	// If you need full BCD ARR accuracy, the flags and result
+	// calculation changes significantly. Most software doesn't use it.
+}
+
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::axs6502()
+{
+	// AXS: X = (A & X) - immediate, sets flags like CMP
+	// Does NOT use borrow (like CMP, not SBC)
+	value = get6502memory(savepc);
+	uint8_t temp = A & X;
+	uint16_t result = (uint16_t)temp - value;
+
+	X = (uint8_t)result;
+
+	// Set carry if no borrow (like CMP)
+	if (temp >= value)
+		P |= F_C;
+	else
+		P &= ~F_C;
+
+	set_nz(X);
+}
+
+
+// -----------------------------------------------------------------------------
+// ANE / XAA (0x8B)
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::ane6502()
+{
+	value = get6502memory(savepc);
+	A = (A | 0xEE) & X & value;  // Magic constant 0xEE
+	set_nz(A);
+}
+
+// -----------------------------------------------------------------------------
+// LXA / ATX (0xAB)
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::lxa6502()
+{
+	value = get6502memory(savepc);
+	A = X = (A | 0xEE) & value;  // Magic constant 0xEE
+	set_nz(A);
+}
+
+// -----------------------------------------------------------------------------
+// SHS / TAS (0x9B)
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::shs6502()
+{
+	S = A & X;
+	uint16_t addr_before_index = savepc - Y;
+	uint8_t high_byte = (addr_before_index >> 8) & 0xFF;
+	uint8_t store_value = A & X & ((high_byte + 1) & 0xFF);
+	put6502memory(savepc, store_value);
+}
+
+// -----------------------------------------------------------------------------
+// SHY / SAY (0x9C)
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::shy6502()
+{
+	uint16_t addr_before_index = savepc - X;
+	uint8_t high_byte = (addr_before_index >> 8) & 0xFF;
+	uint8_t store_value = Y & ((high_byte + 1) & 0xFF);
+	put6502memory(savepc, store_value);
+}
+
+// -----------------------------------------------------------------------------
+// SHX / SXA (0x9E)
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::shx6502()
+{
+	uint16_t addr_before_index = savepc - Y;
+	uint8_t high_byte = (addr_before_index >> 8) & 0xFF;
+	uint8_t store_value = X & ((high_byte + 1) & 0xFF);
+	put6502memory(savepc, store_value);
+}
+
+// -----------------------------------------------------------------------------
+// AHX / SHA (0x93, 0x9F)
+// -----------------------------------------------------------------------------
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::ahx6502()
+{
+	// 0x93 is AHX (ZP), Y
+	uint8_t zp_ptr = get6502memory(savepc++);
+
+	// 1. Fetch the base address from Zero Page
+	uint8_t low = get6502memory(zp_ptr);
+	uint8_t high = get6502memory((zp_ptr + 1) & 0xFF);
+	uint16_t base_addr = (high << 8) | low;
+
+	// 2. Compute the store value
+	// Logic: A & X & (HighByte + 1)
+	uint8_t store_value = A & X & (high + 1);
+
+	// 3. Final Address Calculation
+	uint16_t target_addr = base_addr + Y;
+
+	// 4. Page Cross Corruption (Crucial for AccuracyCoin)
+	// If Y causes a page cross, the high byte of the address 
+	// written to is often A & X & (high + 1).
+	if ((base_addr >> 8) != (target_addr >> 8)) {
+		target_addr = (store_value << 8) | (target_addr & 0xFF);
+	}
+
+	put6502memory(target_addr, store_value);
+}
+
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::las6502()
+{
+	value = get6502memory(savepc);
+	S &= value;
+	A = X = S;
+	set_nz(A);
+}
+
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::enable_instruction_profile(bool s)
+{
+	if (!s)
+		instruction_count.reset();
+	else if (!instruction_count)
+		instruction_count = std::make_unique<uint64_t[]>(256);
+}
+
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::log_instruction_usage()
+{
+	if (!instruction_count)
+		return;
+
+	LOG_INFO("Instruction Usage This Frame:");
+	for (int i = 0; i < 256; ++i)
+	{
+		if (instruction_count[i] > 0)
+		{
+			LOG_INFO("Opcode %02X (%s): %llu", i, mnemonics[i], instruction_count[i]);
+		}
+	}
+}
+
+template <class Hooks, class Bus>
+void cpu_6502_core<Hooks, Bus>::reset_instruction_counts()
+{
+	if (instruction_count)
+		std::fill(instruction_count.get(), instruction_count.get() + 256, 0);
+}
+
+template <class Hooks, class Bus>
+std::string cpu_6502_core<Hooks, Bus>::disassemble(uint16_t pc, int* bytesUsed)
+{
+	static const uint8_t length[256] = {
+		2,2,1,1,2,2,2,1,1,2,1,1,3,3,3,1,  // 00-0F
+		2,2,2,1,2,2,2,1,1,3,1,1,3,3,3,1,  // 10-1F
+		3,2,1,1,2,2,2,1,1,2,1,1,3,3,3,1,  // 20-2F
+		2,2,2,1,2,2,2,1,1,3,1,1,3,3,3,1,  // 30-3F
+		1,2,1,1,1,2,2,1,1,2,1,1,3,3,3,1,  // 40-4F
+		2,2,2,1,1,2,2,1,1,3,1,1,1,3,3,1,  // 50-5F
+		1,2,1,1,2,2,2,1,1,2,1,1,3,3,3,1,  // 60-6F
+		2,2,2,1,2,2,2,1,1,3,1,1,3,3,3,1,  // 70-7F
+		2,2,1,1,2,2,2,1,1,2,1,1,3,3,3,1,  // 80-8F
+		2,2,2,1,2,2,2,1,1,3,1,1,3,3,3,1,  // 90-9F
+		2,2,2,1,2,2,2,1,1,2,1,1,3,3,3,1,  // A0-AF
+		2,2,1,1,2,2,2,1,1,3,1,1,3,3,3,1,  // B0-BF
+		2,2,1,1,2,2,2,1,1,2,1,1,3,3,3,1,  // C0-CF
+		2,2,2,1,1,2,2,1,1,3,1,1,3,3,3,1,  // D0-DF
+		2,2,1,2,2,2,2,2,1,2,1,2,3,3,3,3,  // E0-EF
+		2,2,2,2,2,2,2,2,1,3,1,3,3,3,3,3   // F0-FF
+	};
+
+	char buffer[64] = {};
+	uint8_t opcode = peek(pc);
+	uint8_t op1 = peek(pc + 1);
+	uint8_t op2 = peek(pc + 2);
+
+	switch (length[opcode])
+	{
+	case 1:
+		sprintf_s(buffer, sizeof(buffer), "%02X       %-4s", opcode, mnemonics[opcode]);
+		break;
+
+	case 2:
+		if ((opcode & 0x1F) == 0x10) // branch instructions
+		{
+			int8_t offset = static_cast<int8_t>(op1);
+			uint16_t target = pc + 2 + offset;
+			sprintf_s(buffer, sizeof(buffer), "%02X %02X    %-4s $%04X", opcode, op1, mnemonics[opcode], target);
+		}
+		else
+		{
+			sprintf_s(buffer, sizeof(buffer), "%02X %02X    %-4s $%02X", opcode, op1, mnemonics[opcode], op1);
+		}
+		break;
+
+	case 3:
+	{
+		uint16_t addr = static_cast<uint16_t>(op1) | (static_cast<uint16_t>(op2) << 8);
+		if (opcode == 0x4C || opcode == 0x20) // JMP abs, JSR abs
+		{
+			sprintf_s(buffer, sizeof(buffer), "%02X %02X %02X %-4s $%04X", opcode, op1, op2, mnemonics[opcode], addr);
+		}
+		else if (opcode == 0x6C) // JMP (indirect)
+		{
+			sprintf_s(buffer, sizeof(buffer), "%02X %02X %02X %-4s ($%04X)", opcode, op1, op2, mnemonics[opcode], addr);
+		}
+		else
+		{
+			sprintf_s(buffer, sizeof(buffer), "%02X %02X %02X %-4s $%02X%02X", opcode, op1, op2, mnemonics[opcode], op2, op1);
+		}
+		break;
+	}
+
+	default:
+		sprintf_s(buffer, sizeof(buffer), "%02X       ???", opcode);
+		break;
+	}
+
+	if (bytesUsed)
+		*bytesUsed = length[opcode];
+
+	return std::string(buffer);
+}
@@ -0,0 +1,124 @@
+// -----------------------------------------------------------------------------
+// AAE (Another Arcade Emulator) - 6502 CPU Core Bus Policies
+//
+// This file is part of the AAE project and is released under The Unlicense.
+// You are free to use, modify, and distribute this software without restriction.
+// See <http://unlicense.org/> for details.
+//
+// The core's second template parameter decides how accesses that miss the page
+// map are resolved: cpu_6502_core<Hooks, Bus>.
+//
+// cpu6502_handler_bus, the default, searches the MemoryReadByte/MemoryWriteByte
+// tables given to the constructor and calls the matching handler through its
+// function pointer. Use it whenever the handlers can change at run time.
+//
+// cpu6502_fixed_bus<Board> is for boards whose map never changes. The board
+// describes it once as a constexpr table of ranges, and the core resolves each
+// access with inlined comparisons against that table and calls the board's
+// io_read/io_write directly, with no handler walk and no function pointer.
+// Whole pages of RAM or ROM still go through the page map like any other bus.
+//
+//   struct MyBoard : cpu6502_fixed_bus<MyBoard>
+//   {
+//       enum { PIA, SOUND };
+//       static constexpr cpu6502_bus_range ranges[] = {
+//           bus_ram(0x0000, 0x07FF),
+//           bus_io(0x2000, 0x2007, PIA),
+//           bus_io_write(0x3000, 0x3000, SOUND),
+//           bus_rom(0x8000, 0xFFFF),
+//       };
+//       uint8_t io_read(int device, uint16_t offset);
+//       void io_write(int device, uint16_t offset, uint8_t data);
+//       int io_peek(int device, uint16_t offset) const;   // Optional
+//   };
+//   cpu_6502_core<cpu6502_null_hooks, MyBoard> cpu(mem, nullptr, nullptr, 0xFFFF, 0);
+//
+// RAM and ROM ranges are backed by the CPU's MEM image at the same address.
+// The first range holding an address wins, as with the handler tables. An
+// address no range covers is unhandled: reads return 0 and writes are dropped.
+// A last bus_ram(0x0000, 0xFFFF) makes everything else plain MEM instead.
+// The on_handler_* hooks are not called with a fixed bus, there is no entry.
+// The board object lives in the CPU as cpu.bus.
+// -----------------------------------------------------------------------------
+
+#ifndef _6502_BUS_H_
+#define _6502_BUS_H_
+
+#pragma once
+
+#include <cstdint>
+
+// How one direction of a range is served
+enum cpu6502_bus_kind : uint8_t
+{
+	BUS_NONE, // Reads return 0, writes are dropped
+	BUS_MEM,  // The MEM image
+	BUS_IO    // Board io_read/io_write
+};
+
+struct cpu6502_bus_range
+{
+	uint16_t lo, hi;
+	cpu6502_bus_kind read, write;
+	uint8_t device; // Passed to io_read/io_write for BUS_IO
+};
+
+constexpr cpu6502_bus_range bus_ram(uint16_t lo, uint16_t hi) { return { lo, hi, BUS_MEM, BUS_MEM, 0 }; }
+constexpr cpu6502_bus_range bus_rom(uint16_t lo, uint16_t hi) { return { lo, hi, BUS_MEM, BUS_NONE, 0 }; }
+constexpr cpu6502_bus_range bus_io(uint16_t lo, uint16_t hi, uint8_t device) { return { lo, hi, BUS_IO, BUS_IO, device }; }
+// Latches and strobes: the write goes to the board, reads see MEM.
+constexpr cpu6502_bus_range bus_io_write(uint16_t lo, uint16_t hi, uint8_t device) { return { lo, hi, BUS_MEM, BUS_IO, device }; }
+// Input ports: the read comes from the board, writes land in MEM.
+constexpr cpu6502_bus_range bus_io_read(uint16_t lo, uint16_t hi, uint8_t device) { return { lo, hi, BUS_IO, BUS_MEM, device }; }
+
+// -----------------------------------------------------------------------------
+// Runtime handler tables. The default.
+// -----------------------------------------------------------------------------
+struct cpu6502_handler_bus
+{
+	static constexpr bool fixed = false;
+};
+
+// -----------------------------------------------------------------------------
+// Fixed map, see above. Board derives from cpu6502_fixed_bus<Board>.
+// -----------------------------------------------------------------------------
+template <class Board>
+struct cpu6502_fixed_bus
+{
+	static constexpr bool fixed = true;
+
+	// Index into Board::ranges of the first range holding addr, -1 if none.
+	// A linear search, but it only runs for accesses the page map missed,
+	// and the tables are short.
+	static constexpr int find(uint16_t addr)
+	{
+		const int count = (int)(sizeof(Board::ranges) / sizeof(Board::ranges[0]));
+		for (int i = 0; i < count; i++)
+		{
+			if (addr >= Board::ranges[i].lo && addr <= Board::ranges[i].hi)
+				return i;
+		}
+		return -1;
+	}
+
+	// Index of the one range covering the whole of a page, -1 if the
+	// page is split between ranges or only partly covered.
+	static constexpr int page_range(unsigned int page)
+	{
+		const unsigned int first = page << 8, last = first | 0xFF;
+		const int count = (int)(sizeof(Board::ranges) / sizeof(Board::ranges[0]));
+		for (int i = 0; i < count; i++)
+		{
+			const cpu6502_bus_range& r = Board::ranges[i];
+			if (r.hi < first || r.lo > last)
+				continue;
+			return (r.lo <= first && r.hi >= last) ? i : -1;
+		}
+		return -1;
+	}
+
+	// Side-effect-free read for the debugger, -1 to show MEM instead.
+	int io_peek(int, uint16_t) const { return -1; }
+};
+
+#endif // _6502_BUS_H_
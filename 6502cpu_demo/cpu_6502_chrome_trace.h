@@ -0,0 +1,52 @@
+// -----------------------------------------------------------------------------
+// AAE (Another Arcade Emulator) - 6502 Chrome Trace Hooks
+//
+// This file is part of the AAE project and is released under The Unlicense.
+// You are free to use, modify, and distribute this software without restriction.
+// See <http://unlicense.org/> for details.
+//
+// Hook policy that records every exec6502 call as a slice, and every IRQ and
+// NMI as an instant, on the CPU's lane of the Trace buffer (sys_trace.h). Only
+// the exec and interrupt hooks are used, so the per-instruction path is the
+// same as the default core. Nothing is recorded unless Trace::enable() is on.
+// -----------------------------------------------------------------------------
+
+#ifndef _6502_CHROME_TRACE_H_
+#define _6502_CHROME_TRACE_H_
+
+#pragma once
+
+#include "cpu_6502_hooks.h"
+#include "sys_trace.h"
+
+struct cpu6502_chrome_trace_hooks : cpu6502_default_hooks
+{
+	uint64_t slice_start_ns = 0;
+	uint64_t slice_start_cycle = 0;
+
+	template <class Cpu> void on_exec_begin(Cpu& cpu, int)
+	{
+		if (!Trace::enabled())
+			return;
+		slice_start_ns = Trace::now_ns();
+		slice_start_cycle = cpu.get_cycles();
+	}
+
+	template <class Cpu> void on_exec_end(Cpu& cpu, int)
+	{
+		if (!Trace::enabled())
+			return;
+		Trace::complete("exec6502", Trace::cpu_lane(cpu.get_cpu_num()), slice_start_ns, Trace::now_ns(),
+			cpu.get_cpu_num(), slice_start_cycle, cpu.get_cycles());
+	}
+
+	template <class Cpu> void on_irq(Cpu& cpu, cpu6502_interrupt type, uint16_t)
+	{
+		if (!Trace::enabled())
+			return;
+		Trace::instant(type == INT_NMI ? "NMI" : "IRQ", Trace::cpu_lane(cpu.get_cpu_num()),
+			cpu.get_cpu_num(), cpu.get_cycles());
+	}
+};
+
+#endif // _6502_CHROME_TRACE_H_
@@ -0,0 +1,86 @@
+// -----------------------------------------------------------------------------
+// AAE (Another Arcade Emulator) - 6502 Code Coverage
+//
+// This file is part of the AAE project and is released under The Unlicense.
+// You are free to use, modify, and distribute this software without restriction.
+// See <http://unlicense.org/> for details.
+// -----------------------------------------------------------------------------
+
+#include <cstring>
+#include "cpu_6502_coverage.h"
+#include "sys_log.h"
+
+static const char coverage_magic[8] = { '6','5','0','2','C','O','V','1' };
+
+int cpu6502_coverage::count(const uint8_t* bits)
+{
+	int n = 0;
+	for (int i = 0; i < 8192; i++)
+	{
+		for (uint8_t b = bits[i]; b; b &= b - 1)
+			n++;
+	}
+	return n;
+}
+
+void cpu6502_coverage::clear()
+{
+	memset(exec, 0, sizeof(exec));
+	memset(read, 0, sizeof(read));
+	memset(write, 0, sizeof(write));
+}
+
+bool cpu6502_coverage::save(const char* filename) const
+{
+	FILE* fp = nullptr;
+	if (fopen_s(&fp, filename, "wb") != 0 || !fp)
+	{
+		LOG_ERROR("Coverage: can't create %s", filename);
+		return false;
+	}
+
+	bool ok = fwrite(coverage_magic, sizeof(coverage_magic), 1, fp) == 1
+		&& fwrite(exec, sizeof(exec), 1, fp) == 1
+		&& fwrite(read, sizeof(read), 1, fp) == 1
+		&& fwrite(write, sizeof(write), 1, fp) == 1;
+
+	fclose(fp);
+	return ok;
+}
+
+// ORs the file into the current bitmaps.
+bool cpu6502_coverage::load(const char* filename)
+{
+	FILE* fp = nullptr;
+	if (fopen_s(&fp, filename, "rb") != 0 || !fp)
+		return false;
+
+	char magic[8];
+	cpu6502_coverage in;
+	bool ok = fread(magic, sizeof(magic), 1, fp) == 1
+		&& memcmp(magic, coverage_magic, sizeof(magic)) == 0
+		&& fread(in.exec, sizeof(in.exec), 1, fp) == 1
+		&& fread(in.read, sizeof(in.read), 1, fp) == 1
+		&& fread(in.write, sizeof(in.write), 1, fp) == 1;
+
+	fclose(fp);
+
+	if (!ok)
+	{
+		LOG_ERROR("Coverage: %s is not a coverage file", filename);
+		return false;
+	}
+
+	for (int i = 0; i < 8192; i++)
+	{
+		exec[i] |= in.exec[i];
+		read[i] |= in.read[i];
+		write[i] |= in.write[i];
+	}
+	return true;
+}
+
+void cpu6502_coverage::log_summary() const
+{
+	LOG_INFO("Coverage: %d addresses executed, %d read, %d written", count(exec), count(read), count(write));
+}
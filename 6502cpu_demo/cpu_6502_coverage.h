@@ -0,0 +1,129 @@
+// -----------------------------------------------------------------------------
+// AAE (Another Arcade Emulator) - 6502 Code Coverage
+//
+// This file is part of the AAE project and is released under The Unlicense.
+// You are free to use, modify, and distribute this software without restriction.
+// See <http://unlicense.org/> for details.
+//
+// Executed, read and written address bitmaps, one bit per address. The cost is
+// one OR per access, cheap enough to leave on for a whole regression run.
+//
+// Usage:
+//   cpu_6502_core<cpu6502_coverage_hooks> cpu(...);
+//   ... run ...
+//   cpu.hooks.cov.save("asteroid.cov");
+//   cpu6502_write_coverage_listing(cpu, cpu.hooks.cov, "asteroid.lst", 0x6800, 0x7fff);
+//
+// load() ORs a saved file into the current bitmaps, so a replay corpus can be
+// run one recording at a time and accumulated.
+//
+// File format, all little endian:
+//   char     magic[8]      "6502COV1"
+//   uint8_t  exec[8192]    bit (addr & 7) of byte (addr >> 3)
+//   uint8_t  read[8192]
+//   uint8_t  write[8192]
+// -----------------------------------------------------------------------------
+
+#ifndef _6502_COVERAGE_H_
+#define _6502_COVERAGE_H_
+
+#pragma once
+
+#include <cstdio>
+#include <cstdint>
+#include <string>
+#include "cpu_6502_hooks.h"
+
+struct cpu6502_coverage
+{
+	uint8_t exec[8192] = {};
+	uint8_t read[8192] = {};
+	uint8_t write[8192] = {};
+
+	static void mark(uint8_t* bits, uint16_t addr) { bits[addr >> 3] |= (uint8_t)(1 << (addr & 7)); }
+	static bool test(const uint8_t* bits, uint16_t addr) { return (bits[addr >> 3] >> (addr & 7)) & 1; }
+	static int count(const uint8_t* bits);
+
+	bool executed(uint16_t addr) const { return test(exec, addr); }
+	bool was_read(uint16_t addr) const { return test(read, addr); }
+	bool was_written(uint16_t addr) const { return test(write, addr); }
+
+	void clear();
+	bool save(const char* filename) const;
+	bool load(const char* filename);
+	void log_summary() const;
+};
+
+// -----------------------------------------------------------------------------
+// Hook policy. Opcode fetches mark exec, operand bytes are marked as reads.
+// -----------------------------------------------------------------------------
+struct cpu6502_coverage_hooks : cpu6502_default_hooks
+{
+	cpu6502_coverage cov;
+
+	template <class Cpu> void on_fetch(Cpu&, uint16_t pc, uint8_t) { cpu6502_coverage::mark(cov.exec, pc); }
+	template <class Cpu> void on_read(Cpu&, uint16_t addr, uint8_t) { cpu6502_coverage::mark(cov.read, addr); }
+	template <class Cpu> void on_write(Cpu&, uint16_t addr, uint8_t) { cpu6502_coverage::mark(cov.write, addr); }
+};
+
+// -----------------------------------------------------------------------------
+// Annotated disassembly of lo..hi. Linear sweep, re-synchronised at every
+// executed address so code reached only by a jump into an operand still lines
+// up. Column 1 is X for an executed instruction, the R/W columns are set if any
+// byte on the line was read or written.
+// -----------------------------------------------------------------------------
+template <class Cpu>
+bool cpu6502_write_coverage_listing(Cpu& cpu, const cpu6502_coverage& cov, const char* filename, uint16_t lo, uint16_t hi)
+{
+	FILE* fp = nullptr;
+	if (fopen_s(&fp, filename, "w") != 0 || !fp)
+		return false;
+
+	int total = 0, hit = 0;
+	for (unsigned int addr = lo; addr <= hi; addr++)
+		hit += cov.executed((uint16_t)addr);
+
+	fprintf(fp, "; 6502 coverage listing $%04X-$%04X\n", lo, hi);
+	fprintf(fp, "; X = executed, R = read, W = written (operand fetches count as reads)\n\n");
+
+	unsigned int addr = lo;
+	while (addr <= hi)
+	{
+		int bytes = 1;
+		std::string text = cpu.disassemble((uint16_t)addr, &bytes);
+		const bool exec = cov.executed((uint16_t)addr);
+
+		// Don't let an unexecuted decode swallow an executed address.
+		int len = 1;
+		while (len < bytes && addr + len <= hi && !cov.executed((uint16_t)(addr + len)))
+			len++;
+
+		if (len < bytes && !exec)
+		{
+			char buf[16];
+			text.clear();
+			for (int i = 0; i < len; i++)
+			{
+				sprintf_s(buf, sizeof(buf), i ? ",$%02X" : ".byte $%02X", cpu.peek((uint16_t)(addr + i)));
+				text += buf;
+			}
+		}
+
+		bool r = false, w = false;
+		for (int i = 0; i < len; i++)
+		{
+			r |= cov.was_read((uint16_t)(addr + i));
+			w |= cov.was_written((uint16_t)(addr + i));
+		}
+
+		fprintf(fp, "%c%c%c  %04X  %s\n", exec ? 'X' : ' ', r ? 'R' : ' ', w ? 'W' : ' ', addr, text.c_str());
+		total++;
+		addr += len;
+	}
+
+	fprintf(fp, "\n; %d lines, %d executed instructions\n", total, hit);
+	fclose(fp);
+	return true;
+}
+
+#endif // _6502_COVERAGE_H_
@@ -0,0 +1,100 @@
+// -----------------------------------------------------------------------------
+// AAE (Another Arcade Emulator) - 6502 Memory Handler Latency Profiler
+//
+// This file is part of the AAE project and is released under The Unlicense.
+// You are free to use, modify, and distribute this software without restriction.
+// See <http://unlicense.org/> for details.
+// -----------------------------------------------------------------------------
+
+#include <cstdio>
+#include "cpu_6502_handler_timing.h"
+#include "sys_log.h"
+
+void cpu6502_handler_stats::add(uint64_t ns)
+{
+	calls++;
+	total_ns += ns;
+	if (ns > max_ns)
+		max_ns = ns;
+
+	int bucket = 0;
+	while (bucket < 39 && (ns >> bucket))
+		bucket++;
+	buckets[bucket]++;
+}
+
+uint64_t cpu6502_handler_stats::percentile(double p) const
+{
+	if (!calls)
+		return 0;
+
+	const uint64_t target = (uint64_t)(p * (double)calls + 0.5);
+	uint64_t seen = 0;
+	for (int bucket = 0; bucket < 40; bucket++)
+	{
+		seen += buckets[bucket];
+		if (seen >= target && seen)
+			return bucket ? (1ull << bucket) : 0;
+	}
+	return max_ns;
+}
+
+void cpu6502_handler_timing::clear()
+{
+	reads.clear();
+	writes.clear();
+}
+
+static std::string handler_line(const char* kind, unsigned int i, unsigned int lo, unsigned int hi,
+	const cpu6502_handler_stats& s)
+{
+	char buf[160];
+	sprintf_s(buf, sizeof(buf), "%-5s %2u %04X-%04X %10llu calls %10.3f ms total %8llu ns mean  p50<%llu p99<%llu max %llu ns",
+		kind, i, lo, hi, (unsigned long long)s.calls, s.total_ns / 1.0e6,
+		(unsigned long long)(s.total_ns / s.calls),
+		(unsigned long long)s.percentile(0.50), (unsigned long long)s.percentile(0.99),
+		(unsigned long long)s.max_ns);
+	return buf;
+}
+
+std::vector<std::string> cpu6502_handler_timing::report(const MemoryReadByte* rd, const MemoryWriteByte* wr) const
+{
+	std::vector<std::string> lines;
+	lines.push_back("Memory handler latency:");
+
+	for (size_t i = 0; rd && rd[i].lowAddr != (unsigned)-1 && i < reads.size(); i++)
+	{
+		if (reads[i].calls)
+			lines.push_back(handler_line("Read", (unsigned)i, rd[i].lowAddr, rd[i].highAddr, reads[i]));
+	}
+
+	for (size_t i = 0; wr && wr[i].lowAddr != (unsigned)-1 && i < writes.size(); i++)
+	{
+		if (writes[i].calls)
+			lines.push_back(handler_line("Write", (unsigned)i, wr[i].lowAddr, wr[i].highAddr, writes[i]));
+	}
+
+	return lines;
+}
+
+void cpu6502_handler_timing::log_report(const MemoryReadByte* rd, const MemoryWriteByte* wr) const
+{
+	for (const std::string& line : report(rd, wr))
+		LOG_INFO("%s", line.c_str());
+}
+
+bool cpu6502_handler_timing::write_report(const char* filename, const MemoryReadByte* rd, const MemoryWriteByte* wr) const
+{
+	FILE* fp = nullptr;
+	if (fopen_s(&fp, filename, "w") != 0 || !fp)
+	{
+		LOG_ERROR("Handler timing: can't create %s", filename);
+		return false;
+	}
+
+	for (const std::string& line : report(rd, wr))
+		fprintf(fp, "%s\n", line.c_str());
+
+	fclose(fp);
+	return true;
+}
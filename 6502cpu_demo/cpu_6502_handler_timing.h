@@ -0,0 +1,128 @@
+// -----------------------------------------------------------------------------
+// AAE (Another Arcade Emulator) - 6502 Memory Handler Latency Profiler
+//
+// This file is part of the AAE project and is released under The Unlicense.
+// You are free to use, modify, and distribute this software without restriction.
+// See <http://unlicense.org/> for details.
+//
+// Times every memoryCall handler with steady_clock and keeps a call count and a
+// log2 nanosecond histogram per handler table entry. Device work done inside a
+// CPU access (DVG list decode, bank copies, PIA reads) then shows up as its own
+// line instead of being folded into the frame's CPU time.
+//
+// Usage:
+//   cpu_6502_core<cpu6502_handler_timing_hooks> cpu(...);
+//   ... run ...
+//   cpu6502_log_handler_timing(cpu, cpu.hooks.timing);
+//   cpu6502_write_handler_timing(cpu, cpu.hooks.timing, "handlers.txt");
+// -----------------------------------------------------------------------------
+
+#ifndef _6502_HANDLER_TIMING_H_
+#define _6502_HANDLER_TIMING_H_
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "cpu_6502_hooks.h"
+
+struct cpu6502_handler_stats
+{
+	uint64_t calls = 0;
+	uint64_t total_ns = 0;
+	uint64_t max_ns = 0;
+	uint32_t buckets[40] = {}; // Bucket n holds calls that took < 2^n ns
+
+	void add(uint64_t ns);
+	uint64_t percentile(double p) const; // Upper bound of the bucket holding p
+};
+
+struct cpu6502_handler_timing
+{
+	// Indexed by entry position in the handler table.
+	std::vector<cpu6502_handler_stats> reads;
+	std::vector<cpu6502_handler_stats> writes;
+
+	void record(std::vector<cpu6502_handler_stats>& v, size_t index, uint64_t ns)
+	{
+		if (index >= v.size())
+			v.resize(index + 1);
+		v[index].add(ns);
+	}
+
+	void clear();
+	std::vector<std::string> report(const MemoryReadByte* rd, const MemoryWriteByte* wr) const;
+	void log_report(const MemoryReadByte* rd, const MemoryWriteByte* wr) const;
+	bool write_report(const char* filename, const MemoryReadByte* rd, const MemoryWriteByte* wr) const;
+};
+
+// -----------------------------------------------------------------------------
+// Hook policy. Buffer (pUserArea) entries are plain loads and aren't timed.
+// Handlers can nest, a $4014 write that runs dma_copy reads through other
+// handlers, so start times are kept on a stack and each handler's time
+// includes the handlers it called.
+// -----------------------------------------------------------------------------
+struct cpu6502_handler_timing_hooks : cpu6502_default_hooks
+{
+	static const int MAX_DEPTH = 8; // Deeper calls are still counted, not timed
+
+	cpu6502_handler_timing timing;
+	std::chrono::steady_clock::time_point starts[MAX_DEPTH];
+	int depth = 0;
+
+	template <class Cpu> void on_handler_read(Cpu&, const MemoryReadByte* entry, uint16_t)
+	{
+		if (entry->memoryCall)
+			begin();
+	}
+
+	template <class Cpu> void on_handler_read_done(Cpu& cpu, const MemoryReadByte* entry)
+	{
+		if (entry->memoryCall)
+			timing.record(timing.reads, entry - cpu.get_read_handlers(), end());
+	}
+
+	template <class Cpu> void on_handler_write(Cpu&, const MemoryWriteByte* entry, uint16_t)
+	{
+		if (entry->memoryCall)
+			begin();
+	}
+
+	template <class Cpu> void on_handler_write_done(Cpu& cpu, const MemoryWriteByte* entry)
+	{
+		if (entry->memoryCall)
+			timing.record(timing.writes, entry - cpu.get_write_handlers(), end());
+	}
+
+	void begin()
+	{
+		if (depth < MAX_DEPTH)
+			starts[depth] = std::chrono::steady_clock::now();
+		depth++;
+	}
+
+	// Nanoseconds since the matching begin(), 0 past MAX_DEPTH.
+	uint64_t end()
+	{
+		if (--depth >= MAX_DEPTH)
+			return 0;
+		return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now() - starts[depth]).count();
+	}
+};
+
+template <class Cpu>
+void cpu6502_log_handler_timing(Cpu& cpu, const cpu6502_handler_timing& timing)
+{
+	timing.log_report(cpu.get_read_handlers(), cpu.get_write_handlers());
+}
+
+template <class Cpu>
+bool cpu6502_write_handler_timing(Cpu& cpu, const cpu6502_handler_timing& timing, const char* filename)
+{
+	return timing.write_report(filename, cpu.get_read_handlers(), cpu.get_write_handlers());
+}
+
+#endif // _6502_HANDLER_TIMING_H_
@@ -0,0 +1,96 @@
+// -----------------------------------------------------------------------------
+// AAE (Another Arcade Emulator) - 6502 Memory Access Heatmap
+//
+// This file is part of the AAE project and is released under The Unlicense.
+// You are free to use, modify, and distribute this software without restriction.
+// See <http://unlicense.org/> for details.
+// -----------------------------------------------------------------------------
+
+#include <cstdio>
+#include <algorithm>
+#include "cpu_6502.h"
+#include "cpu_6502_heatmap.h"
+#include "sys_log.h"
+
+void cpu6502_heatmap::clear()
+{
+	std::fill(std::begin(fetch), std::end(fetch), 0);
+	std::fill(std::begin(read), std::end(read), 0);
+	std::fill(std::begin(write), std::end(write), 0);
+	std::fill(handler_reads.begin(), handler_reads.end(), 0);
+	std::fill(handler_writes.begin(), handler_writes.end(), 0);
+}
+
+// Log scale shading for the page grid, one step per power of 4.
+static char heat_char(uint64_t n)
+{
+	static const char ramp[] = " .:-=+*#%@";
+	int level = 0;
+	while (n && level < 9)
+	{
+		n >>= 2;
+		level++;
+	}
+	return ramp[level];
+}
+
+bool cpu6502_heatmap::write_report(const char* filename, const MemoryReadByte* rd, const MemoryWriteByte* wr,
+	const cpu6502_memory_map& map) const
+{
+	FILE* fp = nullptr;
+	if (fopen_s(&fp, filename, "w") != 0 || !fp)
+	{
+		LOG_ERROR("Heatmap: can't create %s", filename);
+		return false;
+	}
+
+	uint64_t total[256];
+	for (int page = 0; page < 256; page++)
+		total[page] = fetch[page] + read[page] + write[page];
+
+	// Page grid, rows are the high nibble of the page number.
+	fprintf(fp, "Page heatmap (fetch + read + write, log4 scale \" .:-=+*#%%@\")\n\n");
+	fprintf(fp, "      0 1 2 3 4 5 6 7 8 9 A B C D E F\n");
+	for (int row = 0; row < 16; row++)
+	{
+		fprintf(fp, "  %X0 ", row);
+		for (int col = 0; col < 16; col++)
+			fprintf(fp, " %c", heat_char(total[row * 16 + col]));
+		fprintf(fp, "\n");
+	}
+
+	// Page table, busiest first. Map column shows whether reads/writes are direct.
+	int order[256];
+	for (int i = 0; i < 256; i++)
+		order[i] = i;
+	std::stable_sort(order, order + 256, [&](int a, int b) { return total[a] > total[b]; });
+
+	fprintf(fp, "\nPage   Map   %14s %14s %14s\n", "Fetch", "Read", "Write");
+	for (int i = 0; i < 256 && total[order[i]]; i++)
+	{
+		const int page = order[i];
+		fprintf(fp, "%02X00   %c%c    %14llu %14llu %14llu\n", page,
+			map.read[page] ? 'R' : '-', map.write[page] ? 'W' : '-',
+			(unsigned long long)fetch[page], (unsigned long long)read[page], (unsigned long long)write[page]);
+	}
+
+	// Handler tables, in table order.
+	fprintf(fp, "\nRead handlers\n");
+	for (size_t i = 0; rd && rd[i].lowAddr != (unsigned)-1; i++)
+	{
+		fprintf(fp, "  %2u  %04X-%04X  %-6s %14llu\n", (unsigned)i, rd[i].lowAddr, rd[i].highAddr,
+			rd[i].memoryCall ? "call" : "buffer",
+			(unsigned long long)(i < handler_reads.size() ? handler_reads[i] : 0));
+	}
+
+	fprintf(fp, "\nWrite handlers\n");
+	for (size_t i = 0; wr && wr[i].lowAddr != (unsigned)-1; i++)
+	{
+		fprintf(fp, "  %2u  %04X-%04X  %-6s %14llu\n", (unsigned)i, wr[i].lowAddr, wr[i].highAddr,
+			wr[i].memoryCall ? "call" : "buffer",
+			(unsigned long long)(i < handler_writes.size() ? handler_writes[i] : 0));
+	}
+
+	fclose(fp);
+	return true;
+}
@@ -0,0 +1,83 @@
+// -----------------------------------------------------------------------------
+// AAE (Another Arcade Emulator) - 6502 Memory Access Heatmap
+//
+// This file is part of the AAE project and is released under The Unlicense.
+// You are free to use, modify, and distribute this software without restriction.
+// See <http://unlicense.org/> for details.
+//
+// Counts opcode fetches, reads and writes per 256 byte page, and reads and
+// writes per MemoryReadByte/MemoryWriteByte entry. Shows which handlers are
+// hot enough to deserve a fast path and which pages should be mapped directly.
+//
+// Usage:
+//   cpu_6502_core<cpu6502_heatmap_hooks> cpu(...);
+//   ... run an interval ...
+//   cpu6502_write_heatmap(cpu, cpu.hooks.heat, "heatmap.txt");
+//   cpu.hooks.heat.clear();
+// -----------------------------------------------------------------------------
+
+#ifndef _6502_HEATMAP_H_
+#define _6502_HEATMAP_H_
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "cpu_6502_hooks.h"
+
+struct cpu6502_memory_map;
+
+struct cpu6502_heatmap
+{
+	uint64_t fetch[256] = {};
+	uint64_t read[256] = {};  // Data reads, opcode fetches not included
+	uint64_t write[256] = {};
+
+	// Slow path hits, indexed by entry position in the handler table. Opcode
+	// fetches from unmapped handler pages are counted here too.
+	std::vector<uint64_t> handler_reads;
+	std::vector<uint64_t> handler_writes;
+
+	void count_handler(std::vector<uint64_t>& v, size_t index)
+	{
+		if (index >= v.size())
+			v.resize(index + 1);
+		v[index]++;
+	}
+
+	void clear();
+
+	// Writes the page table, a 16x16 page grid and the handler table.
+	bool write_report(const char* filename, const MemoryReadByte* rd, const MemoryWriteByte* wr,
+		const cpu6502_memory_map& map) const;
+};
+
+// -----------------------------------------------------------------------------
+// Hook policy
+// -----------------------------------------------------------------------------
+struct cpu6502_heatmap_hooks : cpu6502_default_hooks
+{
+	cpu6502_heatmap heat;
+
+	template <class Cpu> void on_fetch(Cpu&, uint16_t pc, uint8_t) { heat.fetch[pc >> 8]++; }
+	template <class Cpu> void on_read(Cpu&, uint16_t addr, uint8_t) { heat.read[addr >> 8]++; }
+	template <class Cpu> void on_write(Cpu&, uint16_t addr, uint8_t) { heat.write[addr >> 8]++; }
+
+	template <class Cpu> void on_handler_read(Cpu& cpu, const MemoryReadByte* entry, uint16_t)
+	{
+		heat.count_handler(heat.handler_reads, entry - cpu.get_read_handlers());
+	}
+
+	template <class Cpu> void on_handler_write(Cpu& cpu, const MemoryWriteByte* entry, uint16_t)
+	{
+		heat.count_handler(heat.handler_writes, entry - cpu.get_write_handlers());
+	}
+};
+
+template <class Cpu>
+bool cpu6502_write_heatmap(Cpu& cpu, const cpu6502_heatmap& heat, const char* filename)
+{
+	return heat.write_report(filename, cpu.get_read_handlers(), cpu.get_write_handlers(), cpu.get_memory_map());
+}
+
+#endif // _6502_HEATMAP_H_
@@ -0,0 +1,125 @@
+// -----------------------------------------------------------------------------
+// AAE (Another Arcade Emulator) - 6502 CPU Core Hook Policies
+//
+// This file is part of the AAE project and is released under The Unlicense.
+// You are free to use, modify, and distribute this software without restriction.
+// See <http://unlicense.org/> for details.
+//
+// The core is a template over a hook policy: cpu_6502_core<Hooks>. The execute
+// path calls every hook unconditionally, so a hook the policy leaves empty
+// inlines away to nothing. Derive from cpu6502_default_hooks and hide only the
+// hooks you need. The policy object lives in the CPU as cpu.hooks.
+//
+// cpu6502_default_hooks is the null policy, or the AAE timer policy in an AAE
+// build. Deriving from it keeps the timer running under any instrumentation,
+// so a policy that hides on_retire or on_stall calls the default's version
+// first.
+//
+//   on_fetch(cpu, pc, opcode)           Opcode fetched at pc, before it executes.
+//   on_read(cpu, addr, data)            Every bus read except the opcode fetch.
+//   on_write(cpu, addr, data)           Every bus write.
+//   on_irq(cpu, type, vector)           IRQ or NMI taken, vector is the new PC.
+//   on_retire(cpu, pc, opcode, cycles)  Instruction at pc completed.
+//   on_handler_read(cpu, entry, addr)   Slow path matched a MemoryReadByte entry.
+//   on_handler_write(cpu, entry, addr)  Slow path matched a MemoryWriteByte entry.
+//   on_handler_read_done(cpu, entry)    That entry's access has completed.
+//   on_handler_write_done(cpu, entry)
+//   on_exec_begin(cpu, budget)          exec6502 called with a cycle budget.
+//   on_exec_end(cpu, cycles)            exec6502 returning, cycles actually run.
+//   on_stall(cpu, cycles)               CPU halted between instructions by RDY, or
+//                                       by a DMA started outside exec6502. A DMA
+//                                       started by an instruction is in its
+//                                       on_retire cycles.
+//
+// The on_handler hooks only fire with the default bus. A fixed board map
+// (cpu_6502_bus.h) has no handler entries to pass.
+//
+// A policy that prints the enable_debug() trace sets 'traces'. On any other
+// policy enable_debug(true) logs an error once instead of failing silently.
+//
+// Policies that ship with the core are explicitly instantiated in cpu_6502.cpp.
+// Any other policy is instantiated wherever it is used.
+// -----------------------------------------------------------------------------
+
+#ifndef _6502_HOOKS_H_
+#define _6502_HOOKS_H_
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include "sys_log.h"
+#include "cpu_handler.h"
+
+enum cpu6502_interrupt
+{
+	INT_IRQ,
+	INT_NMI
+};
+
+// -----------------------------------------------------------------------------
+// No instrumentation. The default.
+// -----------------------------------------------------------------------------
+struct cpu6502_null_hooks
+{
+	static constexpr bool traces = false;
+
+	template <class Cpu> void on_fetch(Cpu&, uint16_t, uint8_t) {}
+	template <class Cpu> void on_read(Cpu&, uint16_t, uint8_t) {}
+	template <class Cpu> void on_write(Cpu&, uint16_t, uint8_t) {}
+	template <class Cpu> void on_irq(Cpu&, cpu6502_interrupt, uint16_t) {}
+	template <class Cpu> void on_retire(Cpu&, uint16_t, uint8_t, int) {}
+	template <class Cpu> void on_handler_read(Cpu&, const MemoryReadByte*, uint16_t) {}
+	template <class Cpu> void on_handler_write(Cpu&, const MemoryWriteByte*, uint16_t) {}
+	template <class Cpu> void on_handler_read_done(Cpu&, const MemoryReadByte*) {}
+	template <class Cpu> void on_handler_write_done(Cpu&, const MemoryWriteByte*) {}
+	template <class Cpu> void on_exec_begin(Cpu&, int) {}
+	template <class Cpu> void on_exec_end(Cpu&, int) {}
+	template <class Cpu> void on_stall(Cpu&, int) {}
+};
+
+// -----------------------------------------------------------------------------
+// Instruction trace to the log, one line per instruction while
+// enable_debug(true) is set on the CPU.
+// -----------------------------------------------------------------------------
+struct cpu6502_trace_hooks : cpu6502_null_hooks
+{
+	static constexpr bool traces = true;
+
+	template <class Cpu> void on_fetch(Cpu& cpu, uint16_t pc, uint8_t)
+	{
+		if (!cpu.debug_enabled())
+			return;
+
+		int bytes = 0;
+		std::string op = cpu.disassemble(pc, &bytes);
+		LOG_INFO("%04X: %-20s A:%02X X:%02X Y:%02X S:%02X P:%02X",
+			pc, op.c_str(), cpu.A, cpu.X, cpu.Y, cpu.S, cpu.m6502_get_reg(Cpu::M6502_P));
+	}
+};
+
+// -----------------------------------------------------------------------------
+// AAE timer system. Feeds every retired instruction's cycles to timer_update.
+// -----------------------------------------------------------------------------
+#ifdef USING_AAE_EMU
+#include "timer.h"
+
+struct cpu6502_aae_timer_hooks : cpu6502_null_hooks
+{
+	template <class Cpu> void on_retire(Cpu& cpu, uint16_t, uint8_t, int cycles)
+	{
+		timer_update(cycles, cpu.get_cpu_num());
+	}
+
+	template <class Cpu> void on_stall(Cpu& cpu, int cycles)
+	{
+		timer_update(cycles, cpu.get_cpu_num());
+	}
+};
+
+typedef cpu6502_aae_timer_hooks cpu6502_default_hooks;
+#else
+typedef cpu6502_null_hooks cpu6502_default_hooks;
+#endif // USING_AAE_EMU
+
+#endif // _6502_HOOKS_H_
@@ -0,0 +1,132 @@
+// -----------------------------------------------------------------------------
+// AAE (Another Arcade Emulator) - 6502 Sampling Profiler
+//
+// This file is part of the AAE project and is released under The Unlicense.
+// You are free to use, modify, and distribute this software without restriction.
+// See <http://unlicense.org/> for details.
+// -----------------------------------------------------------------------------
+
+#include <cstdio>
+#include <algorithm>
+#include "cpu_6502.h"
+#include "cpu_6502_sampler.h"
+#include "sys_log.h"
+
+void cpu6502_sampler::sample(uint16_t pc, uint8_t opcode, uint8_t sp)
+{
+	unwind(sp);
+
+	samples++;
+	pc_hits[pc]++;
+	opcode_hits[opcode]++;
+
+	if (!depth)
+	{
+		top_level_hits++;
+		return;
+	}
+
+	self_hits[stack[depth - 1].entry]++;
+
+	// Count each routine once per sample, even if it recursed.
+	for (int i = 0; i < depth; i++)
+	{
+		bool seen = false;
+		for (int j = i + 1; j < depth && !seen; j++)
+			seen = stack[j].entry == stack[i].entry;
+		if (!seen)
+			inclusive_hits[stack[i].entry]++;
+	}
+}
+
+void cpu6502_sampler::clear()
+{
+	std::fill(pc_hits.begin(), pc_hits.end(), 0);
+	std::fill(self_hits.begin(), self_hits.end(), 0);
+	std::fill(inclusive_hits.begin(), inclusive_hits.end(), 0);
+	std::fill(std::begin(opcode_hits), std::end(opcode_hits), 0);
+	top_level_hits = 0;
+	samples = 0;
+	depth = 0;
+	countdown = interval;
+}
+
+// Indices of the top_n largest non-zero entries, largest first.
+template <class T>
+static std::vector<int> top_entries(const T* hits, int size, int top_n)
+{
+	std::vector<int> order;
+	for (int i = 0; i < size; i++)
+	{
+		if (hits[i])
+			order.push_back(i);
+	}
+
+	std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return hits[a] > hits[b]; });
+	if ((int)order.size() > top_n)
+		order.resize(top_n);
+	return order;
+}
+
+std::vector<std::string> cpu6502_sampler::report(int top_n) const
+{
+	std::vector<std::string> lines;
+	char buf[128];
+
+	sprintf_s(buf, sizeof(buf), "PC sampling profile, %llu samples every %d cycles", (unsigned long long)samples, interval);
+	lines.push_back(buf);
+	if (!samples)
+		return lines;
+
+	const double scale = 100.0 / (double)samples;
+
+	lines.push_back("Routines (self%  incl%  entry)");
+	for (int entry : top_entries(self_hits.data(), 65536, top_n))
+	{
+		sprintf_s(buf, sizeof(buf), "  %6.2f%% %6.2f%%  $%04X", self_hits[entry] * scale, inclusive_hits[entry] * scale, entry);
+		lines.push_back(buf);
+	}
+	if (top_level_hits)
+	{
+		sprintf_s(buf, sizeof(buf), "  %6.2f%%          (not in a routine)", top_level_hits * scale);
+		lines.push_back(buf);
+	}
+
+	lines.push_back("Hot PCs");
+	for (int pc : top_entries(pc_hits.data(), 65536, top_n))
+	{
+		sprintf_s(buf, sizeof(buf), "  %6.2f%%  $%04X", pc_hits[pc] * scale, pc);
+		lines.push_back(buf);
+	}
+
+	lines.push_back("Opcodes");
+	for (int op : top_entries(opcode_hits, 256, top_n))
+	{
+		sprintf_s(buf, sizeof(buf), "  %6.2f%%  %02X %s", opcode_hits[op] * scale, op, cpu6502_tables::mnemonics[op]);
+		lines.push_back(buf);
+	}
+
+	return lines;
+}
+
+void cpu6502_sampler::log_report(int top_n) const
+{
+	for (const std::string& line : report(top_n))
+		LOG_INFO("%s", line.c_str());
+}
+
+bool cpu6502_sampler::write_report(const char* filename, int top_n) const
+{
+	FILE* fp = nullptr;
+	if (fopen_s(&fp, filename, "w") != 0 || !fp)
+	{
+		LOG_ERROR("Sampler: can't create %s", filename);
+		return false;
+	}
+
+	for (const std::string& line : report(top_n))
+		fprintf(fp, "%s\n", line.c_str());
+
+	fclose(fp);
+	return true;
+}
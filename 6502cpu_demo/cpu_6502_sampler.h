@@ -0,0 +1,121 @@
+// -----------------------------------------------------------------------------
+// AAE (Another Arcade Emulator) - 6502 Sampling Profiler
+//
+// This file is part of the AAE project and is released under The Unlicense.
+// You are free to use, modify, and distribute this software without restriction.
+// See <http://unlicense.org/> for details.
+//
+// Statistical PC sampler. Every 'interval' emulated cycles it records the PC,
+// the opcode and the routine being executed, taken from a shadow call stack of
+// JSR targets and interrupt vectors. The cost per instruction is one compare for
+// JSR and one subtract for the countdown, so it can stay on for soak tests.
+//
+// The shadow stack is kept honest by the real stack pointer: a frame is dropped
+// as soon as S rises above the value it had right after the call, which also
+// covers code that discards a return address with PLA/PLA or resets S with TXS.
+//
+// Usage:
+//   cpu_6502_core<cpu6502_sampler_hooks> cpu(...);
+//   ... run ...
+//   cpu.hooks.prof.log_report(20);
+//   cpu.hooks.prof.write_report("profile.txt");
+// -----------------------------------------------------------------------------
+
+#ifndef _6502_SAMPLER_H_
+#define _6502_SAMPLER_H_
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "cpu_6502_hooks.h"
+
+struct cpu6502_sampler
+{
+	// A prime, so the samples don't lock onto a loop or frame period.
+	static const int DEFAULT_INTERVAL = 10007;
+	static const int MAX_DEPTH = 64;
+
+	struct Frame
+	{
+		uint16_t entry; // JSR target or interrupt vector
+		uint8_t sp;     // S right after the call pushed its return address
+	};
+
+	int interval = DEFAULT_INTERVAL;
+	int countdown = DEFAULT_INTERVAL;
+
+	Frame stack[MAX_DEPTH];
+	int depth = 0;
+
+	uint64_t samples = 0;
+	std::vector<uint32_t> pc_hits;        // 64K, samples per PC
+	std::vector<uint32_t> self_hits;      // 64K, samples per innermost routine
+	std::vector<uint32_t> inclusive_hits; // 64K, samples per routine anywhere on the stack
+	uint32_t top_level_hits = 0;          // Samples with no routine on the stack
+	uint32_t opcode_hits[256] = {};
+
+	cpu6502_sampler() : pc_hits(65536), self_hits(65536), inclusive_hits(65536) {}
+
+	void set_interval(int cycles) { interval = countdown = cycles > 0 ? cycles : DEFAULT_INTERVAL; }
+
+	void push(uint16_t entry, uint8_t sp)
+	{
+		// Anything at this depth or deeper has already returned.
+		while (depth && stack[depth - 1].sp <= sp)
+			depth--;
+
+		if (depth == MAX_DEPTH)
+		{
+			// Runaway recursion or a lost return, keep the innermost frames.
+			for (int i = 1; i < MAX_DEPTH; i++)
+				stack[i - 1] = stack[i];
+			depth--;
+		}
+		stack[depth++] = { entry, sp };
+	}
+
+	// Drop frames that S has risen above.
+	void unwind(uint8_t sp)
+	{
+		while (depth && stack[depth - 1].sp < sp)
+			depth--;
+	}
+
+	void sample(uint16_t pc, uint8_t opcode, uint8_t sp);
+	void clear();
+
+	std::vector<std::string> report(int top_n) const;
+	void log_report(int top_n = 20) const;
+	bool write_report(const char* filename, int top_n = 100) const;
+};
+
+// -----------------------------------------------------------------------------
+// Hook policy
+// -----------------------------------------------------------------------------
+struct cpu6502_sampler_hooks : cpu6502_default_hooks
+{
+	cpu6502_sampler prof;
+
+	template <class Cpu> void on_retire(Cpu& cpu, uint16_t pc, uint8_t opcode, int cycles)
+	{
+		cpu6502_default_hooks::on_retire(cpu, pc, opcode, cycles);
+
+		if (opcode == 0x20) // JSR, PC is now the target
+			prof.push(cpu.PC, cpu.S);
+
+		if ((prof.countdown -= cycles) <= 0)
+		{
+			prof.countdown += prof.interval;
+			prof.sample(pc, opcode, cpu.S);
+		}
+	}
+
+	template <class Cpu> void on_irq(Cpu& cpu, cpu6502_interrupt, uint16_t vector)
+	{
+		prof.push(vector, cpu.S);
+	}
+};
+
+#endif // _6502_SAMPLER_H_
@@ -0,0 +1,168 @@
+// -----------------------------------------------------------------------------
+// AAE (Another Arcade Emulator) - 6502 Opcode Sequence Profiler
+//
+// This file is part of the AAE project and is released under The Unlicense.
+// You are free to use, modify, and distribute this software without restriction.
+// See <http://unlicense.org/> for details.
+// -----------------------------------------------------------------------------
+
+#include <cstdio>
+#include <algorithm>
+#include <utility>
+#include "cpu_6502.h"
+#include "cpu_6502_sequence.h"
+#include "sys_log.h"
+
+// Branches, JMP, JSR, RTS, RTI and BRK. 0x7C (65C02 JMP (abs,X)) and 0x80
+// (65C02 BRA) are included, on NMOS they are a NOP and end a block early.
+const uint8_t cpu6502_sequence_profile::ends_block[256] = {
+	1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,  // 00-0F
+	1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,  // 10-1F
+	1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,  // 20-2F
+	1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,  // 30-3F
+	1,0,0,0,0,0,0,0,0,0,0,0,1,0,0,0,  // 40-4F
+	1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,  // 50-5F
+	1,0,0,0,0,0,0,0,0,0,0,0,1,0,0,0,  // 60-6F
+	1,0,0,0,0,0,0,0,0,0,0,0,1,0,0,0,  // 70-7F
+	1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,  // 80-8F
+	1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,  // 90-9F
+	0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,  // A0-AF
+	1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,  // B0-BF
+	0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,  // C0-CF
+	1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,  // D0-DF
+	0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,  // E0-EF
+	1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0   // F0-FF
+};
+
+// NMOS addressing modes, so the report can tell LDA zp from LDA abs.
+static const char* const mode_names[256] = {
+	"",   "izx","",   "izx","zp", "zp", "zp", "zp", "",   "imm","A",  "imm","abs","abs","abs","abs", // 00-0F
+	"rel","izy","",   "izy","zpx","zpx","zpx","zpx","",   "aby","",   "aby","abx","abx","abx","abx", // 10-1F
+	"abs","izx","",   "izx","zp", "zp", "zp", "zp", "",   "imm","A",  "imm","abs","abs","abs","abs", // 20-2F
+	"rel","izy","",   "izy","zpx","zpx","zpx","zpx","",   "aby","",   "aby","abx","abx","abx","abx", // 30-3F
+	"",   "izx","",   "izx","zp", "zp", "zp", "zp", "",   "imm","A",  "imm","abs","abs","abs","abs", // 40-4F
+	"rel","izy","",   "izy","zpx","zpx","zpx","zpx","",   "aby","",   "aby","abx","abx","abx","abx", // 50-5F
+	"",   "izx","",   "izx","zp", "zp", "zp", "zp", "",   "imm","A",  "imm","ind","abs","abs","abs", // 60-6F
+	"rel","izy","",   "izy","zpx","zpx","zpx","zpx","",   "aby","",   "aby","abx","abx","abx","abx", // 70-7F
+	"imm","izx","imm","izx","zp", "zp", "zp", "zp", "",   "imm","",   "imm","abs","abs","abs","abs", // 80-8F
+	"rel","izy","",   "izy","zpx","zpx","zpy","zpy","",   "aby","",   "aby","abx","abx","aby","aby", // 90-9F
+	"imm","izx","imm","izx","zp", "zp", "zp", "zp", "",   "imm","",   "imm","abs","abs","abs","abs", // A0-AF
+	"rel","izy","",   "izy","zpx","zpx","zpy","zpy","",   "aby","",   "aby","abx","abx","aby","aby", // B0-BF
+	"imm","izx","imm","izx","zp", "zp", "zp", "zp", "",   "imm","",   "imm","abs","abs","abs","abs", // C0-CF
+	"rel","izy","",   "izy","zpx","zpx","zpx","zpx","",   "aby","",   "aby","abx","abx","abx","abx", // D0-DF
+	"imm","izx","imm","izx","zp", "zp", "zp", "zp", "",   "imm","",   "imm","abs","abs","abs","abs", // E0-EF
+	"rel","izy","",   "izy","zpx","zpx","zpx","zpx","",   "aby","",   "aby","abx","abx","abx","abx"  // F0-FF
+};
+
+void cpu6502_sequence_profile::clear()
+{
+	std::fill(pairs.begin(), pairs.end(), 0);
+	triples.clear();
+	std::fill(std::begin(block_lengths), std::end(block_lengths), 0);
+	instructions = 0;
+	history = 0;
+	run = 0;
+}
+
+// "LDA zp" style name for one opcode.
+static std::string op_name(uint8_t op)
+{
+	std::string s = cpu6502_tables::mnemonics[op];
+	if (*mode_names[op])
+	{
+		s += ' ';
+		s += mode_names[op];
+	}
+	return s;
+}
+
+std::vector<std::string> cpu6502_sequence_profile::report(int top_n) const
+{
+	std::vector<std::string> lines;
+	char buf[160];
+
+	uint64_t blocks = 0;
+	uint64_t in_blocks = 0;
+	for (int len = 1; len <= MAX_BLOCK; len++)
+	{
+		blocks += block_lengths[len];
+		in_blocks += block_lengths[len] * len;
+	}
+
+	sprintf_s(buf, sizeof(buf), "Opcode sequences, %llu instructions, %llu basic blocks, mean block %.2f instructions",
+		(unsigned long long)instructions, (unsigned long long)blocks, blocks ? (double)in_blocks / blocks : 0.0);
+	lines.push_back(buf);
+	if (!instructions)
+		return lines;
+
+	const double scale = 100.0 / (double)instructions;
+
+	// The percentage is of all executed instructions that started the sequence.
+	std::vector<std::pair<uint32_t, uint32_t>> ranked;
+	for (uint32_t i = 0; i < 65536; i++)
+	{
+		if (pairs[i])
+			ranked.push_back({ i, pairs[i] });
+	}
+	std::stable_sort(ranked.begin(), ranked.end(), [](const std::pair<uint32_t, uint32_t>& a, const std::pair<uint32_t, uint32_t>& b) { return a.second > b.second; });
+	if ((int)ranked.size() > top_n)
+		ranked.resize(top_n);
+
+	lines.push_back("Pairs (count  %  opcodes)");
+	for (const auto& p : ranked)
+	{
+		sprintf_s(buf, sizeof(buf), "  %12u %6.2f%%  %02X %02X  %s -> %s", p.second, p.second * scale,
+			p.first >> 8, p.first & 0xFF, op_name(p.first >> 8).c_str(), op_name(p.first & 0xFF).c_str());
+		lines.push_back(buf);
+	}
+
+	ranked.assign(triples.begin(), triples.end());
+	std::sort(ranked.begin(), ranked.end(), [](const std::pair<uint32_t, uint32_t>& a, const std::pair<uint32_t, uint32_t>& b)
+		{ return a.second != b.second ? a.second > b.second : a.first < b.first; });
+	if ((int)ranked.size() > top_n)
+		ranked.resize(top_n);
+
+	lines.push_back("Triples (count  %  opcodes)");
+	for (const auto& t : ranked)
+	{
+		const uint8_t a = t.first >> 16, b = (t.first >> 8) & 0xFF, c = t.first & 0xFF;
+		sprintf_s(buf, sizeof(buf), "  %12u %6.2f%%  %02X %02X %02X  %s -> %s -> %s", t.second, t.second * scale,
+			a, b, c, op_name(a).c_str(), op_name(b).c_str(), op_name(c).c_str());
+		lines.push_back(buf);
+	}
+
+	// Share of blocks and of executed instructions by block length.
+	lines.push_back("Block lengths (length  blocks%  instructions%)");
+	for (int len = 1; len <= MAX_BLOCK; len++)
+	{
+		if (!block_lengths[len])
+			continue;
+		sprintf_s(buf, sizeof(buf), "  %3d%s %6.2f%% %6.2f%%", len, len == MAX_BLOCK ? "+" : " ",
+			100.0 * block_lengths[len] / blocks, 100.0 * block_lengths[len] * len / in_blocks);
+		lines.push_back(buf);
+	}
+
+	return lines;
+}
+
+void cpu6502_sequence_profile::log_report(int top_n) const
+{
+	for (const std::string& line : report(top_n))
+		LOG_INFO("%s", line.c_str());
+}
+
+bool cpu6502_sequence_profile::write_report(const char* filename, int top_n) const
+{
+	FILE* fp = nullptr;
+	if (fopen_s(&fp, filename, "w") != 0 || !fp)
+	{
+		LOG_ERROR("Sequence profile: can't create %s", filename);
+		return false;
+	}
+
+	for (const std::string& line : report(top_n))
+		fprintf(fp, "%s\n", line.c_str());
+
+	fclose(fp);
+	return true;
+}
@@ -0,0 +1,98 @@
+// -----------------------------------------------------------------------------
+// AAE (Another Arcade Emulator) - 6502 Opcode Sequence Profiler
+//
+// This file is part of the AAE project and is released under The Unlicense.
+// You are free to use, modify, and distribute this software without restriction.
+// See <http://unlicense.org/> for details.
+//
+// Counts executed opcode pairs and triples (DEX -> BNE, LDA zp -> STA abs, ...)
+// and dynamic basic block lengths. The report ranks them, which is the data
+// needed to choose and tune fused instructions or any block caching.
+//
+// A block ends at a branch, jump, call, return or BRK, and at an interrupt.
+// Pairs and triples are only counted inside a block, since a fused sequence
+// can't cross a control transfer.
+//
+// This is a profiling mode, the triple map is not free. Usage:
+//   cpu_6502_core<cpu6502_sequence_hooks> cpu(...);
+//   ... run ...
+//   cpu.hooks.seq.log_report(20);
+//   cpu.hooks.seq.write_report("sequences.txt");
+// -----------------------------------------------------------------------------
+
+#ifndef _6502_SEQUENCE_H_
+#define _6502_SEQUENCE_H_
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "cpu_6502_hooks.h"
+
+struct cpu6502_sequence_profile
+{
+	static const int MAX_BLOCK = 64;       // Longer blocks are counted as 64
+	static const uint8_t ends_block[256];
+
+	uint64_t instructions = 0;
+	std::vector<uint32_t> pairs;                      // [first << 8 | second]
+	std::unordered_map<uint32_t, uint32_t> triples;   // first << 16 | second << 8 | third
+	uint64_t block_lengths[MAX_BLOCK + 1] = {};
+
+	uint8_t prev1 = 0, prev2 = 0;
+	int history = 0; // Opcodes in prev1/prev2 that belong to the current block
+	int run = 0;     // Length of the current block so far
+
+	cpu6502_sequence_profile() : pairs(65536) {}
+
+	void retire(uint8_t op)
+	{
+		instructions++;
+		if (history >= 1)
+			pairs[(prev1 << 8) | op]++;
+		if (history >= 2)
+			triples[((uint32_t)prev2 << 16) | (prev1 << 8) | op]++;
+
+		prev2 = prev1;
+		prev1 = op;
+		history++;
+		run++;
+
+		if (ends_block[op])
+			end_block();
+	}
+
+	void end_block()
+	{
+		if (run)
+			block_lengths[run < MAX_BLOCK ? run : MAX_BLOCK]++;
+		run = 0;
+		history = 0;
+	}
+
+	void clear();
+
+	std::vector<std::string> report(int top_n) const;
+	void log_report(int top_n = 20) const;
+	bool write_report(const char* filename, int top_n = 50) const;
+};
+
+// -----------------------------------------------------------------------------
+// Hook policy
+// -----------------------------------------------------------------------------
+struct cpu6502_sequence_hooks : cpu6502_default_hooks
+{
+	cpu6502_sequence_profile seq;
+
+	template <class Cpu> void on_retire(Cpu& cpu, uint16_t pc, uint8_t opcode, int cycles)
+	{
+		cpu6502_default_hooks::on_retire(cpu, pc, opcode, cycles);
+		seq.retire(opcode);
+	}
+
+	template <class Cpu> void on_irq(Cpu&, cpu6502_interrupt, uint16_t) { seq.end_block(); }
+};
+
+#endif // _6502_SEQUENCE_H_
@@ -33,6 +33,9 @@ struct MemoryReadByte
 	unsigned int highAddr;
 	unsigned char(*memoryCall)(unsigned int, struct MemoryReadByte *);
 	void *pUserArea;
+	// Optional. Same as memoryCall but with no side effects, used by the
+	// debugger and disassembler. Leave it NULL and those tools see MEM instead.
+	unsigned char(*debugCall)(unsigned int, struct MemoryReadByte *);
 };
 
 #endif
\ No newline at end of file
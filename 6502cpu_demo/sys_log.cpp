@@ -29,10 +29,27 @@ For more information, please refer to <http://unlicense.org/>
 
 #include <cstdio>
 #include <cstdarg>
+#include <chrono>
+#include <mutex>
+#include <vector>
 #include "sys_log.h"
 
 FILE *stream;
 
+// Every rate limited site that has been reached, for close(). Function statics,
+// so a site reached during another file's static initialization is still safe.
+static std::mutex &rate_limit_lock()
+{
+	static std::mutex lock;
+	return lock;
+}
+
+static std::vector<Log::RateLimit *> &rate_limit_sites()
+{
+	static std::vector<Log::RateLimit *> sites;
+	return sites;
+}
+
 int Log::open(char *filename)
 {
 	errno_t err;
@@ -67,8 +84,51 @@ int Log::write(const char *format, ...)
 }
 
 
+Log::RateLimit::RateLimit(const char *level, const char *file, const char *function, int line, const char *format)
+	: level(level), file(file), function(function), line(line), format(format)
+{
+	std::lock_guard<std::mutex> guard(rate_limit_lock());
+	rate_limit_sites().push_back(this);
+}
+
+
+bool Log::RateLimit::pass(unsigned int *count, long long *ms)
+{
+	hits.fetch_add(1);
+
+	const long long now = std::chrono::duration_cast<std::chrono::milliseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count();
+
+	long long last = last_emit_ms.load();
+	if (last != NEVER && now - last < LOG_RATE_LIMIT_MS)
+		return false;
+
+	// Only one thread wins the right to emit for this interval.
+	if (!last_emit_ms.compare_exchange_strong(last, now))
+		return false;
+
+	*count = hits.exchange(0);
+	*ms = last == NEVER ? 0 : now - last;
+	return true;
+}
+
+
+void Log::RateLimit::flush()
+{
+	const unsigned int held = hits.exchange(0);
+	if (held)
+		write("%s:%s:%d %s x %u more not shown: %s", file, function, line, level, held, format);
+}
+
+
 void Log::close()
 {
+	{
+		std::lock_guard<std::mutex> guard(rate_limit_lock());
+		for (RateLimit *site : rate_limit_sites())
+			site->flush();
+	}
+
 	WRLOG("Closing log, ending program.");
 	if (stream != NULL)
 	{
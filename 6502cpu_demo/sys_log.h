@@ -32,19 +32,103 @@ For more information, please refer to <http://unlicense.org/>
 #ifndef LOG_H
 #define LOG_H
 
+#include <atomic>
+
+// Compile-time log levels. Any call below LOG_MIN_LEVEL expands to nothing, so its
+// arguments are never evaluated. Set LOG_MIN_LEVEL in the project preprocessor
+// definitions, for example LOG_MIN_LEVEL=2 to keep only errors in a release build.
+#define LOG_LEVEL_DEBUG 0
+#define LOG_LEVEL_INFO  1
+#define LOG_LEVEL_ERROR 2
+#define LOG_LEVEL_NONE  3
+
+#ifndef LOG_MIN_LEVEL
+#define LOG_MIN_LEVEL LOG_LEVEL_DEBUG
+#endif
+
+// Rate limited logging. Each call site emits at most one line per LOG_RATE_LIMIT_MS,
+// and the next line it emits reports how many times it fired since the last one:
+// "Warning! Unhandled Read at 3400 x 120000 in last 1000 ms"
+// Hits still held back when the log is closed get one summary line per site.
+// The per-site state is atomic, so sites can be hit from several threads.
+#ifndef LOG_RATE_LIMIT_MS
+#define LOG_RATE_LIMIT_MS 1000
+#endif
+
+#define LOG_RATE_LIMITED(level, str, ...) do { \
+	static Log::RateLimit log_site_limit_(level, __FILE__, __FUNCTION__, __LINE__, str); \
+	unsigned int log_site_hits_; \
+	long long log_site_ms_; \
+	if (log_site_limit_.pass(&log_site_hits_, &log_site_ms_)) { \
+		if (log_site_hits_ > 1) Log::write("%s:%s:%d " level " " str " x %u in last %lld ms", __FILE__, __FUNCTION__, __LINE__, ##__VA_ARGS__, log_site_hits_, log_site_ms_); \
+		else Log::write("%s:%s:%d " level " " str, __FILE__, __FUNCTION__, __LINE__, ##__VA_ARGS__); \
+	} } while (0)
+
+#define LOG_DISABLED() ((void)0)
+
 #define LogOpen(f) Log::open((char *)(f))
 #define LogClose() Log::close()
+
+#if LOG_MIN_LEVEL <= LOG_LEVEL_DEBUG
 #define LOG_DEBUG(str,...) Log::write("%s:%s:%d DEBUG " str, __FILE__, __FUNCTION__, __LINE__, ##__VA_ARGS__)
-#define LOG_ERROR(str,...) Log::write("%s:%s:%d ERROR " str, __FILE__, __FUNCTION__, __LINE__, ##__VA_ARGS__)
+#define LOG_DEBUG_RL(str,...) LOG_RATE_LIMITED("DEBUG", str, ##__VA_ARGS__)
+#else
+#define LOG_DEBUG(str,...) LOG_DISABLED()
+#define LOG_DEBUG_RL(str,...) LOG_DISABLED()
+#endif
+
+#if LOG_MIN_LEVEL <= LOG_LEVEL_INFO
 #define LOG_INFO(str,...) Log::write("%s:%s:%d INFO " str, __FILE__, __FUNCTION__, __LINE__, ##__VA_ARGS__)
+#define LOG_INFO_RL(str,...) LOG_RATE_LIMITED("INFO", str, ##__VA_ARGS__)
 #define WRLOG(str,...) Log::write( str, ##__VA_ARGS__)
 #define wrlog(str,...) Log::write( str, ##__VA_ARGS__)
+#else
+#define LOG_INFO(str,...) LOG_DISABLED()
+#define LOG_INFO_RL(str,...) LOG_DISABLED()
+#define WRLOG(str,...) LOG_DISABLED()
+#define wrlog(str,...) LOG_DISABLED()
+#endif
+
+#if LOG_MIN_LEVEL <= LOG_LEVEL_ERROR
+#define LOG_ERROR(str,...) Log::write("%s:%s:%d ERROR " str, __FILE__, __FUNCTION__, __LINE__, ##__VA_ARGS__)
+#define LOG_ERROR_RL(str,...) LOG_RATE_LIMITED("ERROR", str, ##__VA_ARGS__)
+#else
+#define LOG_ERROR(str,...) LOG_DISABLED()
+#define LOG_ERROR_RL(str,...) LOG_DISABLED()
+#endif
 
 namespace Log
 {
 int open(char *filename);
 int write(const char *format, ...);
 void close();
+
+// Per call site state for the LOG_*_RL macros. Sites register themselves so
+// close() can report the hits they held back.
+class RateLimit
+{
+public:
+	RateLimit(const char *level, const char *file, const char *function, int line, const char *format);
+
+	// Returns true when the site may emit. count receives the number of hits
+	// since the last emitted line, including this one, and ms the time since
+	// that line.
+	bool pass(unsigned int *count, long long *ms);
+
+	// Writes a summary line if hits are being held back.
+	void flush();
+
+private:
+	static const long long NEVER = -1;
+
+	std::atomic<long long> last_emit_ms{ NEVER };
+	std::atomic<unsigned int> hits{ 0 };
+	const char *level;
+	const char *file;
+	const char *function;
+	int line;
+	const char *format;
+};
 }
  
 #endif
\ No newline at end of file
@@ -0,0 +1,306 @@
+/*
+Frame phase timing with HDR style latency histograms.
+
+This is free and unencumbered software released into the public domain.
+
+Anyone is free to copy, modify, publish, use, compile, sell, or
+distribute this software, either in source code form or as a compiled
+binary, for any purpose, commercial or non-commercial, and by any
+means.
+
+In jurisdictions that recognize copyright laws, the author or authors
+of this software dedicate any and all copyright interest in the
+software to the public domain. We make this dedication for the benefit
+of the public at large and to the detriment of our heirs and
+successors. We intend this dedication to be an overt act of
+relinquishment in perpetuity of all present and future rights to this
+software under copyright law.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+
+For more information, please refer to <http://unlicense.org/>
+*/
+
+#include <cstdio>
+#include <cstring>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <deque>
+#include "sys_perf.h"
+#include "sys_trace.h"
+#include "sys_log.h"
+
+using namespace std::chrono;
+
+// -----------------------------------------------------------------------------
+// Histogram. Values under 32us get a bucket each, above that every power of two
+// is split into 16 equal sub-buckets.
+// -----------------------------------------------------------------------------
+int Perf::Histogram::bucket_of(uint32_t us)
+{
+	if (us < 32)
+		return (int)us;
+
+	int msb = 31;
+	while (!(us & (1u << msb)))
+		msb--;
+
+	return 32 + (msb - 5) * 16 + (int)((us >> (msb - 4)) & 15);
+}
+
+uint32_t Perf::Histogram::bucket_top(int bucket)
+{
+	if (bucket < 32)
+		return (uint32_t)bucket;
+
+	const int msb = 5 + (bucket - 32) / 16;
+	const uint32_t sub = (uint32_t)((bucket - 32) % 16);
+	const uint32_t width = 1u << (msb - 4);
+	return ((16 + sub) << (msb - 4)) + (width - 1);
+}
+
+void Perf::Histogram::record(uint32_t us)
+{
+	counts[bucket_of(us)]++;
+	total++;
+	sum_us += us;
+	if (us > max_us)
+		max_us = us;
+}
+
+uint32_t Perf::Histogram::percentile(double p) const
+{
+	if (!total)
+		return 0;
+
+	uint64_t target = (uint64_t)(p * (double)total + 0.5);
+	if (target < 1)
+		target = 1;
+
+	uint64_t seen = 0;
+	for (int bucket = 0; bucket < BUCKETS; bucket++)
+	{
+		seen += counts[bucket];
+		if (seen >= target)
+		{
+			const uint32_t top = bucket_top(bucket);
+			return top < max_us ? top : max_us;
+		}
+	}
+	return max_us;
+}
+
+void Perf::Histogram::clear()
+{
+	memset(counts, 0, sizeof(counts));
+	total = 0;
+	sum_us = 0;
+	max_us = 0;
+}
+
+// -----------------------------------------------------------------------------
+// Phase state
+// -----------------------------------------------------------------------------
+namespace
+{
+	struct PhaseData
+	{
+		std::string name;
+		uint64_t frame_ns = 0;        // Exclusive time this frame
+		bool touched = false;         // Ran at all this frame
+		Perf::Histogram interval;     // Since the last summary
+		Perf::Histogram run;          // Since start or reset()
+	};
+
+	struct Open
+	{
+		int id;
+		steady_clock::time_point start;
+		uint64_t trace_start_ns;
+	};
+
+	// A deque so the name strings stay put, the tracer keeps pointers to them.
+	std::deque<PhaseData> phases;
+	std::vector<Open> stack;
+	steady_clock::time_point last_frame;
+	bool have_last_frame = false;
+	int frame_phase = -1;
+	int summary_interval = 600;
+	int frames_since_summary = 0;
+
+	void charge_top(steady_clock::time_point now)
+	{
+		Open &top = stack.back();
+		phases[top.id].frame_ns += (uint64_t)duration_cast<nanoseconds>(now - top.start).count();
+		top.start = now;
+	}
+
+	void summary_line(const PhaseData &ph, const Perf::Histogram &h, char *buf, size_t size)
+	{
+		sprintf_s(buf, size, "%-8s n=%-7llu mean %8.3f  p50 %8.3f  p90 %8.3f  p99 %8.3f  max %8.3f ms",
+			ph.name.c_str(), (unsigned long long)h.count(), h.mean() / 1000.0,
+			h.percentile(0.50) / 1000.0, h.percentile(0.90) / 1000.0,
+			h.percentile(0.99) / 1000.0, h.max() / 1000.0);
+	}
+}
+
+int Perf::phase(const char *name)
+{
+	for (size_t i = 0; i < phases.size(); i++)
+	{
+		if (phases[i].name == name)
+			return (int)i;
+	}
+
+	phases.emplace_back();
+	phases.back().name = name;
+	return (int)phases.size() - 1;
+}
+
+void Perf::begin(int id)
+{
+	const steady_clock::time_point now = steady_clock::now();
+
+	// Pause the enclosing phase.
+	if (!stack.empty())
+		charge_top(now);
+
+	phases[id].touched = true;
+	stack.push_back({ id, now, Trace::enabled() ? Trace::now_ns() : 0 });
+}
+
+void Perf::end()
+{
+	if (stack.empty())
+		return;
+
+	const steady_clock::time_point now = steady_clock::now();
+	charge_top(now);
+
+	const Open &top = stack.back();
+	if (Trace::enabled())
+		Trace::complete(phases[top.id].name.c_str(), 0, top.trace_start_ns, Trace::now_ns());
+	stack.pop_back();
+
+	// Resume the enclosing phase.
+	if (!stack.empty())
+		stack.back().start = now;
+}
+
+void Perf::frame_end()
+{
+	const steady_clock::time_point now = steady_clock::now();
+
+	if (frame_phase < 0)
+		frame_phase = phase("frame");
+
+	if (have_last_frame)
+	{
+		phases[frame_phase].frame_ns = (uint64_t)duration_cast<nanoseconds>(now - last_frame).count();
+		phases[frame_phase].touched = true;
+	}
+	last_frame = now;
+	have_last_frame = true;
+
+	for (PhaseData &ph : phases)
+	{
+		if (ph.touched)
+		{
+			const uint32_t us = (uint32_t)(ph.frame_ns / 1000);
+			ph.interval.record(us);
+			ph.run.record(us);
+		}
+		ph.frame_ns = 0;
+		ph.touched = false;
+	}
+
+	if (summary_interval && ++frames_since_summary >= summary_interval)
+	{
+		log_summary();
+		for (PhaseData &ph : phases)
+			ph.interval.clear();
+		frames_since_summary = 0;
+	}
+}
+
+void Perf::set_summary_interval(int frames)
+{
+	summary_interval = frames;
+	frames_since_summary = 0;
+}
+
+void Perf::log_summary()
+{
+	if (!frames_since_summary)
+		return;
+
+	char buf[192];
+	wrlog("Frame timing, last %d frames:", frames_since_summary);
+	for (const PhaseData &ph : phases)
+	{
+		if (!ph.interval.count())
+			continue;
+		summary_line(ph, ph.interval, buf, sizeof(buf));
+		wrlog("  %s", buf);
+	}
+}
+
+bool Perf::dump(const char *filename)
+{
+	FILE *fp = nullptr;
+	if (fopen_s(&fp, filename, "w") != 0 || !fp)
+	{
+		LOG_ERROR("Can't create %s", filename);
+		return false;
+	}
+
+	char buf[192];
+	fprintf(fp, "Frame timing for the whole run, exclusive time per phase per frame\n\n");
+	for (const PhaseData &ph : phases)
+	{
+		if (!ph.run.count())
+			continue;
+		summary_line(ph, ph.run, buf, sizeof(buf));
+		fprintf(fp, "%s\n", buf);
+	}
+
+	// Percentile ladder, handy for plotting the tail.
+	static const double ladder[] = { 0.50, 0.75, 0.90, 0.95, 0.99, 0.999, 1.0 };
+	fprintf(fp, "\n%-8s", "ms");
+	for (double p : ladder)
+		fprintf(fp, " %9.1f%%", p * 100.0);
+	fprintf(fp, "\n");
+	for (const PhaseData &ph : phases)
+	{
+		if (!ph.run.count())
+			continue;
+		fprintf(fp, "%-8s", ph.name.c_str());
+		for (double p : ladder)
+			fprintf(fp, " %10.3f", ph.run.percentile(p) / 1000.0);
+		fprintf(fp, "\n");
+	}
+
+	fclose(fp);
+	return true;
+}
+
+void Perf::reset()
+{
+	for (PhaseData &ph : phases)
+	{
+		ph.interval.clear();
+		ph.run.clear();
+		ph.frame_ns = 0;
+		ph.touched = false;
+	}
+	stack.clear();
+	have_last_frame = false;
+	frames_since_summary = 0;
+}
@@ -0,0 +1,103 @@
+/*
+Frame phase timing with HDR style latency histograms.
+
+This is free and unencumbered software released into the public domain.
+
+Anyone is free to copy, modify, publish, use, compile, sell, or
+distribute this software, either in source code form or as a compiled
+binary, for any purpose, commercial or non-commercial, and by any
+means.
+
+In jurisdictions that recognize copyright laws, the author or authors
+of this software dedicate any and all copyright interest in the
+software to the public domain. We make this dedication for the benefit
+of the public at large and to the detriment of our heirs and
+successors. We intend this dedication to be an overt act of
+relinquishment in perpetuity of all present and future rights to this
+software under copyright law.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+
+For more information, please refer to <http://unlicense.org/>
+*/
+
+// Usage:
+//   static int ph_cpu = Perf::phase("cpu");
+//   Perf::begin(ph_cpu); ... Perf::end();    or  { Perf::Scope s(ph_cpu); ... }
+//   Perf::frame_end();                        once per displayed frame
+//   Perf::dump("frame_times.txt");            on exit
+//
+// Phases nest. Time spent in an inner phase is not counted in the outer one, so
+// DVG decode done from inside a CPU write shows up as dvg, not cpu. A phase is
+// summed over the frame and recorded once per frame_end(). The "frame" phase is
+// recorded automatically as the time between frame_end() calls.
+//
+// While Trace (sys_trace.h) is enabled, every begin/end pair is also recorded
+// as a slice on the trace's main lane, with the full (inclusive) duration.
+//
+// Each histogram keeps 16 sub-buckets per power of two microseconds, so the
+// reported percentiles are within about 6% of the true value.
+
+#pragma once
+
+#ifndef PERF_H
+#define PERF_H
+
+#include <cstdint>
+
+namespace Perf
+{
+	// Log-linear microsecond histogram, in the style of HdrHistogram.
+	class Histogram
+	{
+	public:
+		void record(uint32_t us);
+		uint32_t percentile(double p) const;
+		uint32_t max() const { return max_us; }
+		uint64_t count() const { return total; }
+		double mean() const { return total ? (double)sum_us / total : 0.0; }
+		void clear();
+
+		static const int BUCKETS = 32 + 27 * 16;
+
+	private:
+		static int bucket_of(uint32_t us);
+		static uint32_t bucket_top(int bucket);
+
+		uint32_t counts[BUCKETS] = {};
+		uint64_t total = 0;
+		uint64_t sum_us = 0;
+		uint32_t max_us = 0;
+	};
+
+	// Returns the id of a named phase, creating it on first use.
+	int phase(const char *name);
+
+	void begin(int id);
+	void end();
+	void frame_end();
+
+	// Frames between summary lines in the log, 0 to turn the summary off.
+	void set_summary_interval(int frames);
+
+	void log_summary();
+	bool dump(const char *filename);
+	void reset();
+
+	class Scope
+	{
+	public:
+		explicit Scope(int id) { begin(id); }
+		~Scope() { end(); }
+		Scope(const Scope &) = delete;
+		Scope &operator=(const Scope &) = delete;
+	};
+}
+
+#endif
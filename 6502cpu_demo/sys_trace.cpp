@@ -0,0 +1,167 @@
+/*
+Chrome trace-event capture (chrome://tracing, ui.perfetto.dev).
+
+This is free and unencumbered software released into the public domain.
+
+Anyone is free to copy, modify, publish, use, compile, sell, or
+distribute this software, either in source code form or as a compiled
+binary, for any purpose, commercial or non-commercial, and by any
+means.
+
+In jurisdictions that recognize copyright laws, the author or authors
+of this software dedicate any and all copyright interest in the
+software to the public domain. We make this dedication for the benefit
+of the public at large and to the detriment of our heirs and
+successors. We intend this dedication to be an overt act of
+relinquishment in perpetuity of all present and future rights to this
+software under copyright law.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+
+For more information, please refer to <http://unlicense.org/>
+*/
+
+#include <atomic>
+#include <cstdio>
+#include <chrono>
+#include <mutex>
+#include <vector>
+#include "sys_trace.h"
+#include "sys_log.h"
+
+using namespace std::chrono;
+
+namespace
+{
+	struct Event
+	{
+		const char *name;
+		char ph;            // 'X' complete, 'i' instant
+		int lane;
+		int cpu;            // -1 if not a CPU event
+		uint64_t ts_ns;
+		uint64_t dur_ns;
+		uint64_t cycle_begin;
+		uint64_t cycle_end;
+	};
+
+	// Machines on other threads record CPU events, so the buffer is locked.
+	std::atomic<bool> on{ false };
+	std::mutex lock;
+	unsigned int capacity = 0;
+	unsigned int dropped = 0;
+	std::vector<Event> events;
+	steady_clock::time_point origin;
+
+	void push(const Event &e)
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		if (events.size() >= capacity)
+		{
+			dropped++;
+			return;
+		}
+		events.push_back(e);
+	}
+}
+
+void Trace::enable(bool enable_on, unsigned int max_events)
+{
+	std::lock_guard<std::mutex> guard(lock);
+	on = enable_on;
+	if (!enable_on)
+		return;
+
+	capacity = max_events;
+	dropped = 0;
+	events.clear();
+	events.reserve(capacity < 65536 ? capacity : 65536);
+	origin = steady_clock::now();
+}
+
+bool Trace::enabled()
+{
+	return on;
+}
+
+uint64_t Trace::now_ns()
+{
+	return (uint64_t)duration_cast<nanoseconds>(steady_clock::now() - origin).count();
+}
+
+void Trace::complete(const char *name, int lane, uint64_t start_ns, uint64_t end_ns,
+	int cpu, uint64_t cycle_begin, uint64_t cycle_end)
+{
+	if (on)
+		push({ name, 'X', lane, cpu, start_ns, end_ns - start_ns, cycle_begin, cycle_end });
+}
+
+void Trace::instant(const char *name, int lane, int cpu, uint64_t cycle)
+{
+	if (on)
+		push({ name, 'i', lane, cpu, now_ns(), 0, cycle, cycle });
+}
+
+bool Trace::write(const char *filename)
+{
+	FILE *fp = nullptr;
+	if (fopen_s(&fp, filename, "w") != 0 || !fp)
+	{
+		LOG_ERROR("Can't create %s", filename);
+		return false;
+	}
+
+	std::lock_guard<std::mutex> guard(lock);
+	fprintf(fp, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+
+	// Lane names
+	bool named[64] = {};
+	bool first = true;
+	for (const Event &e : events)
+	{
+		if (e.lane < 0 || e.lane >= 64 || named[e.lane])
+			continue;
+		named[e.lane] = true;
+
+		fprintf(fp, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":", first ? "" : ",\n", e.lane);
+		if (e.lane == 0)
+			fprintf(fp, "\"main\"}}");
+		else
+			fprintf(fp, "\"cpu %d\"}}", e.lane - 1);
+		first = false;
+	}
+
+	for (const Event &e : events)
+	{
+		fprintf(fp, "%s{\"name\":\"%s\",\"ph\":\"%c\",\"pid\":1,\"tid\":%d,\"ts\":%.3f",
+			first ? "" : ",\n", e.name, e.ph, e.lane, e.ts_ns / 1000.0);
+		first = false;
+
+		if (e.ph == 'X')
+			fprintf(fp, ",\"dur\":%.3f", e.dur_ns / 1000.0);
+		else
+			fprintf(fp, ",\"s\":\"t\"");
+
+		if (e.cpu >= 0)
+		{
+			if (e.ph == 'X')
+				fprintf(fp, ",\"args\":{\"cpu\":%d,\"cycle\":%llu,\"cycles\":%llu}", e.cpu,
+					(unsigned long long)e.cycle_begin, (unsigned long long)(e.cycle_end - e.cycle_begin));
+			else
+				fprintf(fp, ",\"args\":{\"cpu\":%d,\"cycle\":%llu}", e.cpu, (unsigned long long)e.cycle_begin);
+		}
+		fprintf(fp, "}");
+	}
+
+	fprintf(fp, "\n]}\n");
+	fclose(fp);
+
+	wrlog("Trace: wrote %u events to %s, %u dropped", (unsigned int)events.size(), filename, dropped);
+	return true;
+}
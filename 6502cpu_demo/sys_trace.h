@@ -0,0 +1,84 @@
+/*
+Chrome trace-event capture (chrome://tracing, ui.perfetto.dev).
+
+This is free and unencumbered software released into the public domain.
+
+Anyone is free to copy, modify, publish, use, compile, sell, or
+distribute this software, either in source code form or as a compiled
+binary, for any purpose, commercial or non-commercial, and by any
+means.
+
+In jurisdictions that recognize copyright laws, the author or authors
+of this software dedicate any and all copyright interest in the
+software to the public domain. We make this dedication for the benefit
+of the public at large and to the detriment of our heirs and
+successors. We intend this dedication to be an overt act of
+relinquishment in perpetuity of all present and future rights to this
+software under copyright law.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+IN NO EVENT SHALL THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR
+OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+
+For more information, please refer to <http://unlicense.org/>
+*/
+
+// Usage:
+//   Trace::enable(true);
+//   { Trace::Scope s("draw"); ... }                   a slice on the main lane
+//   Trace::complete("exec6502", lane, t0, t1, cpu, c0, c1);
+//   Trace::instant("NMI", lane, cpu, cycle);
+//   Trace::write("trace.json");                        once, when the run ends
+//
+// Perf phases (sys_perf.h) are traced automatically while tracing is enabled.
+//
+// Events are kept in memory until write(), nothing touches the disk during the
+// run. Lane 0 is the main thread, lane 1 + n is CPU n (see Trace::cpu_lane).
+// CPU events carry the CPU index and the CPU's cycle clock in their args.
+// When the buffer is full further events are dropped and counted. Events can be
+// recorded from any thread; call enable() and write() while nothing is running.
+
+#pragma once
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <cstdint>
+
+namespace Trace
+{
+	void enable(bool on, unsigned int max_events = 1u << 20);
+	bool enabled();
+
+	// Host time in nanoseconds since enable().
+	uint64_t now_ns();
+
+	inline int cpu_lane(int cpu) { return 1 + cpu; }
+
+	// Names must be string literals or otherwise outlive the trace.
+	void complete(const char *name, int lane, uint64_t start_ns, uint64_t end_ns,
+		int cpu = -1, uint64_t cycle_begin = 0, uint64_t cycle_end = 0);
+	void instant(const char *name, int lane, int cpu = -1, uint64_t cycle = 0);
+
+	bool write(const char *filename);
+
+	class Scope
+	{
+	public:
+		explicit Scope(const char *name, int lane = 0) : name(name), lane(lane), start(enabled() ? now_ns() : 0) {}
+		~Scope() { if (enabled()) complete(name, lane, start, now_ns()); }
+		Scope(const Scope &) = delete;
+		Scope &operator=(const Scope &) = delete;
+
+	private:
+		const char *name;
+		int lane;
+		uint64_t start;
+	};
+}
+
+#endif
@@ -36,6 +36,8 @@ For more information, please refer to < http://unlicense.org/>
 #include <stdio.h>
 #include <stdlib.h>
 #include "asteroid.h"
+#include "sys_perf.h"
+#include "sys_trace.h"
 
 #pragma warning (disable : 4996)
 
@@ -173,6 +175,7 @@ int WINAPI WinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance, _
 		
 
 	asteroid_init();
+	int ph_swap = Perf::phase("swap");
 	// ********** Program Main Loop **********
 
 	while (!Quit) {
@@ -195,7 +198,10 @@ int WINAPI WinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance, _
 
 			asteroid_run();
 
+			Perf::begin(ph_swap);
 			GlSwap();
+			Perf::end();
+			Perf::frame_end();
 		}
 	}
 
@@ -204,6 +210,10 @@ int WINAPI WinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance, _
 
 	asteroid_end();
 	DeleteGLContext();
+	Perf::log_summary();
+	Perf::dump("frame_times.txt");
+	if (Trace::enabled())
+		Trace::write("trace.json");
 	LogClose();
 	// destroy the window
 	DestroyWindow(hWnd);